@@ -0,0 +1,276 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Audio Error Budget
+
+// Objetivo:
+// Presupuestar el error audible de las decisiones que ahorran CPU de
+// audio: virtualizar voces, bajar la calidad de reverb y cambiar HRTF
+// por panning, según cuánto enmascara el resto de la mezcla cada voz.
+
+// Filosofía:
+// - Lo que la mezcla tapa no se oye: virtualizarlo es casi gratis
+// - El error audible se mide contra el enmascaramiento, no en absoluto
+// - Miles de voces se evalúan en lote, en tiempo lineal
+// - Mismo sistema de presupuesto que ErrorBudgetSystem
+
+#pragma once
+
+#include "TXErrorBudget.cpp"
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace TX
+{
+
+// Tipos de error de audio
+enum class AudioErrorType : uint8_t
+{
+    Virtualization,   // voz virtual: se sigue su estado pero no se mezcla
+    Reverb,           // envío de reverb de menor calidad
+    Spatialization,   // panning en lugar de HRTF
+    Count
+};
+
+static constexpr uint32_t AUDIO_ERROR_TYPE_COUNT = static_cast<uint32_t>(AudioErrorType::Count);
+
+// Mismo sistema que ErrorBudgetSystem, con tipos de audio y sin
+// acumulación temporal. BeginFrame abre cada tick de audio y conserva
+// los límites ajustados.
+struct AudioErrorTraits
+{
+    using Type = AudioErrorType;
+    static constexpr uint32_t Count         = AUDIO_ERROR_TYPE_COUNT;
+    static constexpr uint32_t TemporalIndex = Count;
+
+    // Límites base (suma de audibilidad tolerada por tick)
+    static constexpr float BaseLimits[Count] =
+    {
+        0.5f, // Virtualization
+        1.0f, // Reverb
+        1.0f  // Spatialization
+    };
+};
+
+using AudioErrorBudgetSystem = BasicErrorBudgetSystem<AudioErrorTraits>;
+using AudioErrorBudgetMark   = BasicErrorBudgetMark<AudioErrorTraits>;
+using AudioErrorBudgetScope  = BasicErrorBudgetScope<AudioErrorTraits>;
+
+// Voz tal como llega al evaluador
+struct AudioVoiceDesc
+{
+    float Gain;       // ganancia lineal en el oyente (volumen * atenuación)
+    bool  Reverb;     // tiene envío de reverb
+    bool  Hrtf;       // se espacializa con HRTF
+};
+
+// Decisión por voz
+struct AudioVoiceDecision
+{
+    float Audibility;      // energía frente a la máscara (0..1)
+    bool  Virtual;
+    bool  ReducedReverb;
+    bool  PanningOnly;
+};
+
+// Coste de CPU por voz (calibrar por plataforma)
+struct AudioCostModel
+{
+    float VoiceUs  = 2.0f;    // decodificación + mezcla
+    float ReverbUs = 3.0f;    // envío de reverb completo (el reducido cuesta la mitad)
+    float HrtfUs   = 4.0f;    // convolución HRTF (panning ~0)
+};
+
+// Evaluador en lote: audibilidad por enmascaramiento y degradación
+// de la voz menos audible a la más audible, tipo a tipo.
+class AudioVoiceBudgetEvaluator
+{
+public:
+    void SetCostModel(const AudioCostModel& model) { Model = model; }
+
+    // Fracción de la energía del resto de la mezcla que actúa como máscara
+    void SetMaskingFactor(float factor) { MaskingFactor = factor; }
+
+    void Evaluate(const AudioVoiceDesc* voices, uint32_t count, AudioErrorBudgetSystem& budget)
+    {
+        Decisions.resize(count);
+        Energy.resize(count);
+
+        // Energía (potencia) de cada voz y de la mezcla
+        float total = 0.0f;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const float energy = voices[i].Gain * voices[i].Gain;
+            Energy[i] = energy;
+            total    += energy;
+        }
+
+        // Audibilidad = energía / (energía + máscara del resto)
+        std::memset(BucketCounts, 0, sizeof(BucketCounts));
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const float mask       = MaskingFactor * (total - Energy[i]) + NOISE_FLOOR;
+            const float audibility = Energy[i] / (Energy[i] + mask);
+
+            AudioVoiceDecision& decision = Decisions[i];
+            decision.Audibility    = audibility;
+            decision.Virtual       = false;
+            decision.ReducedReverb = false;
+            decision.PanningOnly   = false;
+
+            ++BucketCounts[Bucket(audibility)];
+        }
+
+        SortByAudibility(count);
+
+        // Virtualizar lo menos audible; el orden creciente permite parar
+        // en el primer fallo
+        for (uint32_t index : Order)
+        {
+            AudioVoiceDecision& decision = Decisions[index];
+            if (!budget.Request(AudioErrorType::Virtualization, decision.Audibility))
+                break;
+            decision.Virtual = true;
+        }
+
+        for (uint32_t index : Order)
+        {
+            AudioVoiceDecision& decision = Decisions[index];
+            if (decision.Virtual || !voices[index].Reverb)
+                continue;
+            if (!budget.Request(AudioErrorType::Reverb, decision.Audibility * REVERB_WEIGHT))
+                break;
+            decision.ReducedReverb = true;
+        }
+
+        for (uint32_t index : Order)
+        {
+            AudioVoiceDecision& decision = Decisions[index];
+            if (decision.Virtual || !voices[index].Hrtf)
+                continue;
+            if (!budget.Request(AudioErrorType::Spatialization, decision.Audibility * HRTF_WEIGHT))
+                break;
+            decision.PanningOnly = true;
+        }
+
+        AccumulateCost(voices, count);
+    }
+
+    const AudioVoiceDecision& GetDecision(uint32_t voice) const { return Decisions[voice]; }
+
+    // Telemetría
+    float    GetCpuUs() const        { return CpuUs; }
+    float    GetCpuSavedUs() const   { return CpuSavedUs; }
+    uint32_t GetVirtualCount() const { return VirtualCount; }
+
+private:
+    static constexpr float    NOISE_FLOOR    = 1e-6f;   // -60 dB
+    static constexpr float    REVERB_WEIGHT  = 0.3f;    // la reverb reducida se nota menos
+    static constexpr float    HRTF_WEIGHT    = 0.5f;
+    static constexpr uint32_t BUCKET_COUNT   = 256;
+
+    static uint32_t Bucket(float audibility)
+    {
+        return std::min<uint32_t>((uint32_t)(audibility * BUCKET_COUNT), BUCKET_COUNT - 1);
+    }
+
+    // Counting sort por cubos: lineal para miles de voces
+    void SortByAudibility(uint32_t count)
+    {
+        uint32_t offset = 0;
+        for (uint32_t b = 0; b < BUCKET_COUNT; ++b)
+        {
+            const uint32_t voices = BucketCounts[b];
+            BucketCounts[b] = offset;
+            offset += voices;
+        }
+
+        Order.resize(count);
+        for (uint32_t i = 0; i < count; ++i)
+            Order[BucketCounts[Bucket(Decisions[i].Audibility)]++] = i;
+    }
+
+    void AccumulateCost(const AudioVoiceDesc* voices, uint32_t count)
+    {
+        CpuUs        = 0.0f;
+        CpuSavedUs   = 0.0f;
+        VirtualCount = 0;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const AudioVoiceDesc&     voice    = voices[i];
+            const AudioVoiceDecision& decision = Decisions[i];
+
+            const float full = Model.VoiceUs + (voice.Reverb ? Model.ReverbUs : 0.0f)
+                                             + (voice.Hrtf ? Model.HrtfUs : 0.0f);
+            float cost = 0.0f;
+            if (!decision.Virtual)
+            {
+                cost = Model.VoiceUs;
+                if (voice.Reverb)
+                    cost += decision.ReducedReverb ? Model.ReverbUs * 0.5f : Model.ReverbUs;
+                if (voice.Hrtf && !decision.PanningOnly)
+                    cost += Model.HrtfUs;
+            }
+
+            CpuUs        += cost;
+            CpuSavedUs   += full - cost;
+            VirtualCount += decision.Virtual;
+        }
+    }
+
+    std::vector<AudioVoiceDecision> Decisions;
+    std::vector<float>              Energy;
+    std::vector<uint32_t>           Order;
+    uint32_t                        BucketCounts[BUCKET_COUNT];
+
+    AudioCostModel Model;
+    float    MaskingFactor = 0.5f;
+    float    CpuUs         = 0.0f;
+    float    CpuSavedUs    = 0.0f;
+    uint32_t VirtualCount  = 0;
+};
+
+
+// Benchmark del evaluador: tiempo por tick y por voz, y CPU de audio
+// ahorrada frente a mezclar todas las voces a calidad completa
+struct AudioVoiceBenchmarkResult
+{
+    double   EvaluateUs;       // media por Evaluate
+    double   NsPerVoice;
+    float    FullCpuUs;        // todas las voces reales, reverb y HRTF completos
+    float    CpuUs;            // con las decisiones del evaluador
+    uint32_t VirtualCount;
+};
+
+inline AudioVoiceBenchmarkResult RunAudioVoiceBenchmark(const AudioVoiceDesc* voices, uint32_t count,
+                                                        uint32_t ticks)
+{
+    AudioVoiceBenchmarkResult result = {};
+
+    AudioErrorBudgetSystem    budget;
+    AudioVoiceBudgetEvaluator evaluator;
+    ticks = std::max<uint32_t>(1, ticks);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t t = 0; t < ticks; ++t)
+    {
+        budget.BeginFrame();
+        evaluator.Evaluate(voices, count, budget);
+    }
+    result.EvaluateUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ticks;
+    result.NsPerVoice = count ? result.EvaluateUs * 1000.0 / count : 0.0;
+
+    result.CpuUs        = evaluator.GetCpuUs();
+    result.FullCpuUs    = result.CpuUs + evaluator.GetCpuSavedUs();
+    result.VirtualCount = evaluator.GetVirtualCount();
+    return result;
+}
+
+// Ejemplo de uso
+// AudioBudget.BeginFrame();   // cada tick de audio
+// Voices.Evaluate(voiceDescs, voiceCount, AudioBudget);
+// if (Voices.GetDecision(v).Virtual) Mixer.Virtualize(v);
+}
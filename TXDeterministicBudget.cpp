@@ -0,0 +1,251 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Deterministic Budget Resolution
+
+// Objetivo:
+// Que qué peticiones se conceden dentro de un frame no dependa del
+// orden de los hilos: se recogen con una clave estable y se resuelven
+// todas juntas con una suma prefija sobre el orden de la clave.
+
+// Filosofía:
+// - En lockstep, una denegación distinta es una desincronización
+// - La prioridad la da la clave (prioridad, entidad), no el reloj
+// - Sumas en punto fijo: asociativas, idénticas con 1 o con 64 hilos
+// - Se concede el prefijo de cada presupuesto que cabe en lo restante
+
+#pragma once
+
+#include "TXErrorBudget.cpp"
+#include "TXFrameMemoryBudget.cpp"
+#include "TXParallelBudget.cpp"
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+namespace TX
+{
+
+// Canales: un ErrorType o un FrameMemoryDomain
+constexpr uint32_t DETERMINISTIC_CHANNEL_COUNT = ERROR_TYPE_COUNT + (uint32_t)FrameMemoryDomain::Count;
+constexpr uint32_t DETERMINISTIC_BLOCK_SIZE    = 4096;
+constexpr double   DETERMINISTIC_ERROR_SCALE   = 4294967296.0;   // 2^32 unidades por unidad de error
+
+// Petición diferida. (Priority, EntityId, SubId) debe ser única en el frame.
+struct DeterministicRequest
+{
+    uint32_t Priority;   // mayor = antes
+    uint32_t EntityId;
+    uint32_t SubId;      // varias peticiones de la misma entidad
+    uint8_t  Channel;
+    uint64_t Amount;     // bytes o error en punto fijo
+
+    static DeterministicRequest ForError(uint32_t priority, uint32_t entity, uint32_t subId, ErrorType type, float error)
+    {
+        const double fixed = std::max(0.0, (double)error * DETERMINISTIC_ERROR_SCALE);
+        return { priority, entity, subId, (uint8_t)type, (uint64_t)fixed };
+    }
+
+    static DeterministicRequest ForMemory(uint32_t priority, uint32_t entity, uint32_t subId, FrameMemoryDomain domain, uint64_t bytes)
+    {
+        return { priority, entity, subId, (uint8_t)(ERROR_TYPE_COUNT + (uint32_t)domain), bytes };
+    }
+};
+
+struct DeterministicTicket
+{
+    uint32_t ThreadSlot;
+    uint32_t Index;
+};
+
+// Recolección sin locks (un buffer por hilo) y resolución en bloque
+class DeterministicBudgetResolver
+{
+public:
+    // Vacía los buffers; threadSlots = hilos que van a enviar peticiones
+    void BeginFrame(uint32_t threadSlots)
+    {
+        if (Slots.size() < threadSlots)
+            Slots.resize(threadSlots);
+        for (ThreadSlot& slot : Slots)
+        {
+            slot.Requests.clear();
+            slot.Granted.clear();
+        }
+        GrantedCount = 0;
+    }
+
+    // Cada hilo escribe solo en su ranura
+    DeterministicTicket Submit(uint32_t threadSlot, const DeterministicRequest& request)
+    {
+        ThreadSlot& slot = Slots[threadSlot];
+        slot.Requests.push_back(request);
+        return { threadSlot, (uint32_t)slot.Requests.size() - 1 };
+    }
+
+    // Ordena por clave, escanea por bloques fijos en paralelo y cobra
+    // el total concedido de cada canal con una sola petición.
+    template <typename Dispatch = ParallelBudgetThreadDispatch>
+    void Resolve(ErrorBudgetSystem& error, FrameMemoryBudgetSystem* memory,
+                 uint32_t workerCount = 1, const Dispatch& dispatch = Dispatch())
+    {
+        Gather();
+        SortEntries();
+
+        uint64_t remaining[DETERMINISTIC_CHANNEL_COUNT];
+        for (uint32_t t = 0; t < ERROR_TYPE_COUNT; ++t)
+            remaining[t] = (uint64_t)((double)error.GetRemaining((ErrorType)t) * DETERMINISTIC_ERROR_SCALE);
+        for (uint8_t d = 0; d < (uint8_t)FrameMemoryDomain::Count; ++d)
+            remaining[ERROR_TYPE_COUNT + d] = memory ? memory->GetRemaining((FrameMemoryDomain)d) : 0;
+
+        const uint32_t count      = (uint32_t)Entries.size();
+        const uint32_t blockCount = (count + DETERMINISTIC_BLOCK_SIZE - 1) / DETERMINISTIC_BLOCK_SIZE;
+        BlockSums.assign((size_t)blockCount * DETERMINISTIC_CHANNEL_COUNT, 0);
+        BlockGranted.assign((size_t)blockCount * DETERMINISTIC_CHANNEL_COUNT, 0);
+
+        workerCount = std::max<uint32_t>(1, std::min(workerCount, std::max<uint32_t>(blockCount, 1)));
+
+        // 1) Suma por bloque y canal
+        dispatch(workerCount, [&](uint32_t w)
+        {
+            for (uint32_t b = w; b < blockCount; b += workerCount)
+            {
+                uint64_t* sums = &BlockSums[(size_t)b * DETERMINISTIC_CHANNEL_COUNT];
+                const uint32_t end = std::min(count, (b + 1) * DETERMINISTIC_BLOCK_SIZE);
+                for (uint32_t i = b * DETERMINISTIC_BLOCK_SIZE; i < end; ++i)
+                    sums[Entries[i].Request.Channel] += Entries[i].Request.Amount;
+            }
+        });
+
+        // 2) Prefijo exclusivo entre bloques (serie, pocos bloques)
+        uint64_t running[DETERMINISTIC_CHANNEL_COUNT] = {};
+        for (uint32_t b = 0; b < blockCount; ++b)
+        {
+            uint64_t* sums = &BlockSums[(size_t)b * DETERMINISTIC_CHANNEL_COUNT];
+            for (uint32_t c = 0; c < DETERMINISTIC_CHANNEL_COUNT; ++c)
+            {
+                const uint64_t blockSum = sums[c];
+                sums[c]     = running[c];
+                running[c] += blockSum;
+            }
+        }
+
+        // 3) Prefijo dentro de cada bloque: concedido si cabe entero
+        dispatch(workerCount, [&](uint32_t w)
+        {
+            for (uint32_t b = w; b < blockCount; b += workerCount)
+            {
+                uint64_t prefix[DETERMINISTIC_CHANNEL_COUNT];
+                std::memcpy(prefix, &BlockSums[(size_t)b * DETERMINISTIC_CHANNEL_COUNT], sizeof(prefix));
+                uint64_t* granted = &BlockGranted[(size_t)b * DETERMINISTIC_CHANNEL_COUNT];
+
+                const uint32_t end = std::min(count, (b + 1) * DETERMINISTIC_BLOCK_SIZE);
+                for (uint32_t i = b * DETERMINISTIC_BLOCK_SIZE; i < end; ++i)
+                {
+                    Entry& entry = Entries[i];
+                    const uint8_t channel = entry.Request.Channel;
+                    prefix[channel] += entry.Request.Amount;
+
+                    const bool fits = prefix[channel] <= remaining[channel];
+                    Slots[entry.ThreadSlot].Granted[entry.Index] = fits ? 1 : 0;
+                    granted[channel] += fits ? entry.Request.Amount : 0;
+                }
+            }
+        });
+
+        // 4) Cobro: una petición por canal
+        uint64_t total[DETERMINISTIC_CHANNEL_COUNT] = {};
+        for (uint32_t b = 0; b < blockCount; ++b)
+            for (uint32_t c = 0; c < DETERMINISTIC_CHANNEL_COUNT; ++c)
+                total[c] += BlockGranted[(size_t)b * DETERMINISTIC_CHANNEL_COUNT + c];
+
+        for (uint32_t t = 0; t < ERROR_TYPE_COUNT; ++t)
+        {
+            if (total[t] == 0)
+                continue;
+
+            // El redondeo a float puede rozar el límite: se cobra lo que queda
+            const float amount = (float)((double)total[t] / DETERMINISTIC_ERROR_SCALE);
+            if (!error.Request((ErrorType)t, amount))
+                error.Request((ErrorType)t, error.GetRemaining((ErrorType)t));
+        }
+
+        for (uint8_t d = 0; d < (uint8_t)FrameMemoryDomain::Count && memory; ++d)
+        {
+            if (total[ERROR_TYPE_COUNT + d])
+                memory->Request((FrameMemoryDomain)d, total[ERROR_TYPE_COUNT + d]);
+        }
+
+        GrantedCount = 0;
+        for (const ThreadSlot& slot : Slots)
+            for (uint8_t granted : slot.Granted)
+                GrantedCount += granted;
+    }
+
+    bool IsGranted(DeterministicTicket ticket) const
+    {
+        return Slots[ticket.ThreadSlot].Granted[ticket.Index] != 0;
+    }
+
+    uint32_t GetRequestCount() const { return (uint32_t)Entries.size(); }
+    uint32_t GetGrantedCount() const { return GrantedCount; }
+
+private:
+    struct ThreadSlot
+    {
+        std::vector<DeterministicRequest> Requests;
+        std::vector<uint8_t>              Granted;
+    };
+
+    struct Entry
+    {
+        DeterministicRequest Request;
+        uint32_t             ThreadSlot;
+        uint32_t             Index;
+    };
+
+    void Gather()
+    {
+        Entries.clear();
+        for (uint32_t s = 0; s < (uint32_t)Slots.size(); ++s)
+        {
+            ThreadSlot& slot = Slots[s];
+            slot.Granted.assign(slot.Requests.size(), 0);
+            for (uint32_t i = 0; i < (uint32_t)slot.Requests.size(); ++i)
+                Entries.push_back({ slot.Requests[i], s, i });
+        }
+    }
+
+    // Orden total por canal y clave: no depende de qué hilo envió qué
+    void SortEntries()
+    {
+        std::sort(Entries.begin(), Entries.end(), [](const Entry& a, const Entry& b)
+        {
+            const DeterministicRequest& x = a.Request;
+            const DeterministicRequest& y = b.Request;
+            if (x.Channel != y.Channel)
+                return x.Channel < y.Channel;
+            if (x.Priority != y.Priority)
+                return x.Priority > y.Priority;
+            if (x.EntityId != y.EntityId)
+                return x.EntityId < y.EntityId;
+            if (x.SubId != y.SubId)
+                return x.SubId < y.SubId;
+            return x.Amount < y.Amount;
+        });
+    }
+
+    std::vector<ThreadSlot> Slots;
+    std::vector<Entry>      Entries;
+    std::vector<uint64_t>   BlockSums;      // [bloque][canal]
+    std::vector<uint64_t>   BlockGranted;   // [bloque][canal]
+    uint32_t                GrantedCount = 0;
+};
+
+
+// Ejemplo de uso
+// Resolver.BeginFrame(workerCount);
+// tickets[i] = Resolver.Submit(worker, DeterministicRequest::ForError(prio, entity, 0, ErrorType::Spatial, lodError));
+// Resolver.Resolve(ErrorSystem, &MemorySystem, workerCount);
+// if (Resolver.IsGranted(tickets[i])) ApplyLOD(i);
+}
@@ -0,0 +1,228 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Dynamic Resolution Scaling
+
+// Objetivo:
+// Elegir la escala de render de cada frame a partir del tiempo de GPU
+// medido y de una curva escala/tiempo aprendida, cobrando la pérdida de
+// resolución como error Spatial y Shading para que compita con el LOD
+// y las sombras por el mismo presupuesto.
+
+// Filosofía:
+// - Bajar resolución es otra forma de error, no un ajuste gratis
+// - Se predice el tiempo de cada escalón antes de darlo
+// - Bajar rápido para no perder el frame, subir despacio y con margen
+// - Con el presupuesto de error saturado, la resolución devuelve error
+
+#pragma once
+
+#include "TXErrorBudget.cpp"
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+namespace TX
+{
+
+struct DynamicResolutionDesc
+{
+    float MinScale       = 0.5f;    // escala por eje
+    float MaxScale       = 1.0f;
+    float StepSize       = 0.05f;
+    float TargetMs       = 16.0f;   // presupuesto de GPU
+    float Hysteresis     = 0.1f;    // subir solo si el escalón queda por debajo de Target * (1 - h)
+    float Smoothing      = 0.2f;    // peso del frame nuevo en el tiempo suavizado
+    float Forgetting     = 0.98f;   // memoria de la curva aprendida por muestra
+    float SpatialWeight  = 1.0f;    // error por unidad de escala perdida
+    float ShadingWeight  = 0.5f;
+    float SaturationHigh = 0.9f;    // por encima, subir sin histéresis si hay tiempo
+};
+
+struct DynamicResolutionStats
+{
+    float Scale;
+    float SmoothedMs;
+    float PredictedMs;      // tiempo previsto a la escala elegida
+    float SpatialError;     // error cobrado este frame
+    float ShadingError;
+    bool  ErrorLimited;     // el presupuesto impidió bajar lo que pedía el tiempo
+};
+
+class DynamicResolutionController
+{
+public:
+    DynamicResolutionController()
+    {
+        Initialize(DynamicResolutionDesc());
+    }
+
+    void Initialize(const DynamicResolutionDesc& desc)
+    {
+        // Escalones desde MinScale; si el rango no es múltiplo del paso,
+        // el último se acorta para terminar exactamente en MaxScale
+        Desc      = desc;
+        StepCount = (Desc.StepSize > 0.0f && Desc.MaxScale > Desc.MinScale)
+                  ? (uint32_t)std::ceil((Desc.MaxScale - Desc.MinScale) / Desc.StepSize - 1e-4f) + 1
+                  : 1;
+        Step      = StepCount - 1;
+
+        SumW = SumX = SumY = SumXX = SumXY = 0.0f;
+        SmoothedMs     = 0.0f;
+        Load           = 1.0f;
+        LastSaturation = 0.0f;
+        Stats          = {};
+        Stats.Scale    = Desc.MaxScale;
+    }
+
+    // Fin de frame: cuánto gastó el resto del motor de los dos tipos que
+    // cobra la resolución (los demás no compiten con ella)
+    void ObserveFrame(const ErrorBudgetSystem& error)
+    {
+        LastSaturation = std::max(error.GetUsage(ErrorType::Spatial), error.GetUsage(ErrorType::Shading));
+    }
+
+    // Inicio de frame, tras ErrorBudgetSystem::Reset y antes del LOD:
+    // gpuMs = tiempo medido del frame anterior (a la escala de entonces)
+    float Update(float gpuMs, ErrorBudgetSystem& error)
+    {
+        Learn(ScaleOf(Step), gpuMs);
+
+        // La curva da la forma y la carga el nivel. Se suaviza la carga
+        // (medido / curva) y no los ms: un cambio de escala no se arrastra
+        const float current = Predict(ScaleOf(Step));
+        const float load    = (current > 0.0f) ? gpuMs / current : 1.0f;
+        Load       = (SmoothedMs == 0.0f) ? load : Load + (load - Load) * Desc.Smoothing;
+        SmoothedMs = Expected(ScaleOf(Step));
+
+        uint32_t target = std::min(Step, StepCount - 1);
+
+        if (SmoothedMs > Desc.TargetMs)
+        {
+            // Bajar: el escalón más alto cuyo tiempo previsto cabe
+            while (target > 0 && Expected(ScaleOf(target)) > Desc.TargetMs)
+                --target;
+        }
+        else if (target + 1 < StepCount)
+        {
+            // Subir de uno en uno y con margen, salvo que el error esté
+            // saturado: entonces cada escalón devuelto lo aprovecha el LOD
+            const float headroom = (LastSaturation >= Desc.SaturationHigh) ? 0.0f : Desc.Hysteresis;
+            if (Expected(ScaleOf(target + 1)) <= Desc.TargetMs * (1.0f - headroom))
+                ++target;
+        }
+
+        // Cobro: si la pérdida no cabe, se sube hasta que quepa. El tope
+        // es MaxScale exacto y no pierde nada: siempre cabe y se cobra
+        Stats.ErrorLimited = false;
+        while (!Charge(target, error))
+        {
+            Stats.ErrorLimited = true;
+            if (target + 1 >= StepCount)
+                break;
+            ++target;
+        }
+
+        Step = target;
+
+        Stats.Scale       = ScaleOf(Step);
+        Stats.SmoothedMs  = SmoothedMs;
+        Stats.PredictedMs = Expected(Stats.Scale);
+        return Stats.Scale;
+    }
+
+    float GetScale() const { return ScaleOf(Step); }
+
+    // Tiempo previsto a una escala con la carga actual
+    float PredictMs(float scale) const { return Expected(scale); }
+
+    const DynamicResolutionStats& GetStats() const { return Stats; }
+
+private:
+    float ScaleOf(uint32_t step) const
+    {
+        if (step + 1 >= StepCount)
+            return Desc.MaxScale;
+        return std::min(Desc.MaxScale, Desc.MinScale + Desc.StepSize * (float)step);
+    }
+
+    // Cobra la pérdida de los dos tipos a la vez o ninguno
+    bool Charge(uint32_t step, ErrorBudgetSystem& error)
+    {
+        const float loss    = Desc.MaxScale - ScaleOf(step);
+        const float spatial = loss * Desc.SpatialWeight;
+        const float shading = loss * Desc.ShadingWeight;
+
+        Stats.SpatialError = 0.0f;
+        Stats.ShadingError = 0.0f;
+        if (loss <= 0.0f)
+            return true;
+
+        const ErrorBudgetMark mark = error.GetMark();
+        if (!error.Request(ErrorType::Spatial, spatial) || !error.Request(ErrorType::Shading, shading))
+        {
+            error.Rollback(mark);
+            return false;
+        }
+
+        Stats.SpatialError = spatial;
+        Stats.ShadingError = shading;
+        return true;
+    }
+
+    // Regresión lineal ponderada con olvido: ms = a + b * escala²
+    // (coste fijo + coste por píxel)
+    void Learn(float scale, float ms)
+    {
+        const float x = scale * scale;
+        const float f = Desc.Forgetting;
+
+        SumW  = SumW  * f + 1.0f;
+        SumX  = SumX  * f + x;
+        SumY  = SumY  * f + ms;
+        SumXX = SumXX * f + x * x;
+        SumXY = SumXY * f + x * ms;
+    }
+
+    float Expected(float scale) const
+    {
+        return Predict(scale) * Load;
+    }
+
+    float Predict(float scale) const
+    {
+        if (SumW <= 0.0f)
+            return 0.0f;
+
+        const float x     = scale * scale;
+        const float meanX = SumX / SumW;
+        const float meanY = SumY / SumW;
+        const float varX  = SumXX / SumW - meanX * meanX;
+
+        // Sin variedad de escalas aún: tiempo proporcional a los píxeles
+        if (varX < 1e-4f)
+            return meanX > 0.0f ? meanY * x / meanX : meanY;
+
+        const float slope = (SumXY / SumW - meanX * meanY) / varX;
+        return meanY + slope * (x - meanX);
+    }
+
+    DynamicResolutionDesc  Desc;
+    DynamicResolutionStats Stats = {};
+
+    uint32_t StepCount = 1;
+    uint32_t Step      = 0;
+
+    float SumW = 0.0f, SumX = 0.0f, SumY = 0.0f, SumXX = 0.0f, SumXY = 0.0f;
+    float SmoothedMs     = 0.0f;
+    float Load           = 1.0f;   // medido / curva, suavizado
+    float LastSaturation = 0.0f;
+};
+
+
+// Ejemplo de uso
+// ErrorSystem.Reset();
+// const float scale = Resolution.Update(Gpu.GetLastFrameMs(), ErrorSystem);
+// Renderer.SetRenderScale(scale);
+// ... LOD / sombras piden del error restante ...
+// Resolution.ObserveFrame(ErrorSystem);
+}
@@ -11,10 +11,15 @@
 // - El motor decide cuánto error puede permitirse
 // - Cada subsistema consume error como un presupuesto
 
+#pragma once
+
 #include <cstdint>
 #include <cmath>
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <type_traits>
+#include <vector>
 
 namespace TX
 {
@@ -31,6 +36,7 @@ enum class ErrorType : uint8_t
 };
 
 static constexpr uint32_t ERROR_TYPE_COUNT = static_cast<uint32_t>(ErrorType::Count);
+static constexpr uint32_t ERROR_TEMPORAL_WINDOW_MAX = 16;
 
 // Presupuesto de error por tipo
 struct ErrorBudget
@@ -39,50 +45,448 @@ struct ErrorBudget
     float Limit;     // máximo aceptable
 };
 
-// Estado perceptual del frame
+// Estado perceptual del frame. Los campos añadidos tras los tres
+// primeros tienen valores por defecto neutros: un estado inicializado
+// solo con { velocidad, foco, luminancia } da los mismos límites que
+// antes de existir el resto del modelo.
 struct PerceptualState
 {
-    float CameraVelocity;   // movimiento de cámara
-    float FocusDepth;       // profundidad dominante
-    float Luminance;        // brillo medio
+    float CameraVelocity;               // movimiento de cámara
+    float FocusDepth;                   // profundidad dominante
+    float Luminance;                    // brillo medio
+    float Contrast            = 0.0f;   // contraste local medio (0..1)
+    float MotionBlur          = 0.0f;   // desenfoque de movimiento medio (px)
+    float DepthOfField        = 0.0f;   // fracción de pantalla fuera de foco (0..1)
+    float SaliencyMean        = 0.0f;   // media del mapa de saliencia (0..1)
+    float SaliencyPeak        = 0.0f;   // máximo del mapa de saliencia (0..1)
+    float AdaptationLuminance = 1.0f;   // luminancia a la que está adaptado el ojo (autoexposición, 0..1)
+};
+
+// Matemática constexpr para generar tablas en compilación (series en double)
+namespace PerceptualMath
+{
+    constexpr double Exp(double x)
+    {
+        // exp(x) = exp(x / 2^k)^(2^k), Taylor en |x| <= 0.5
+        int k = 0;
+        while (x > 0.5 || x < -0.5)
+        {
+            x *= 0.5;
+            ++k;
+        }
+
+        double term = 1.0, sum = 1.0;
+        for (int n = 1; n < 20; ++n)
+        {
+            term *= x / n;
+            sum  += term;
+        }
+
+        while (k-- > 0)
+            sum *= sum;
+        return sum;
+    }
+
+    constexpr double Log(double x)
+    {
+        // x = m * 2^e con m en [0.75, 1.5]; ln(m) = 2 atanh((m-1)/(m+1))
+        constexpr double LN2 = 0.69314718055994530942;
+        int e = 0;
+        while (x > 1.5)
+        {
+            x *= 0.5;
+            ++e;
+        }
+        while (x < 0.75)
+        {
+            x *= 2.0;
+            --e;
+        }
+
+        const double y  = (x - 1.0) / (x + 1.0);
+        const double y2 = y * y;
+        double term = y, sum = 0.0;
+        for (int n = 1; n < 40; n += 2)
+        {
+            sum  += term / n;
+            term *= y2;
+        }
+        return 2.0 * sum + e * LN2;
+    }
+
+    constexpr double Pow(double x, double a)
+    {
+        return (x <= 0.0) ? 0.0 : Exp(a * Log(x));
+    }
+
+    constexpr double Sqrt(double x)
+    {
+        if (x <= 0.0)
+            return 0.0;
+
+        double r = (x > 1.0) ? x : 1.0;
+        for (int i = 0; i < 64; ++i)
+            r = 0.5 * (r + x / r);
+        return r;
+    }
+
+    constexpr double Abs(double x)
+    {
+        return x < 0.0 ? -x : x;
+    }
+}
+
+// Curvas de respuesta de referencia (constexpr: generan las tablas)
+struct PerceptualCurves
+{
+    static constexpr double BLUR_RANGE_PX = 32.0;
+
+    // Umbral de contraste relativo: DeVries-Rose con poca luz, Weber
+    // con mucha. Normalizado: 0 con luminancia plena, 1 a oscuras.
+    static constexpr double DarkAdaptation(double luminance)
+    {
+        const double cdm2  = 1.0 + luminance * 299.0;   // 0..1 -> 1..300 cd/m²
+        const double full  = PerceptualMath::Sqrt(1.0 + 20.0 / 300.0);
+        const double black = PerceptualMath::Sqrt(1.0 + 20.0);
+        return (PerceptualMath::Sqrt(1.0 + 20.0 / cdm2) - full) / (black - full);
+    }
+
+    // Enmascaramiento por contraste (exponente tipo Legge-Foley)
+    static constexpr double ContrastMask(double contrast)
+    {
+        return PerceptualMath::Pow(contrast, 0.7);
+    }
+
+    // Enmascaramiento por blur, satura con el radio (entrada: px / BLUR_RANGE_PX)
+    static constexpr double BlurMask(double blur)
+    {
+        return 1.0 - PerceptualMath::Exp(-blur * BLUR_RANGE_PX / 8.0);
+    }
+};
+
+// Tablas generadas en compilación. Luminancia y contraste se indexan por
+// su raíz: concentra muestras cerca de 0, donde las curvas son más
+// empinadas (error máximo ~0.003 frente a ~0.2 con paso uniforme).
+constexpr uint32_t PERCEPTUAL_LUT_SIZE = 128;
+
+struct PerceptualTables
+{
+    float DarkAdaptation[PERCEPTUAL_LUT_SIZE + 1];   // por sqrt(luminancia)
+    float ContrastMask[PERCEPTUAL_LUT_SIZE + 1];     // por sqrt(contraste)
+    float BlurMask[PERCEPTUAL_LUT_SIZE + 1];         // por blur / BLUR_RANGE_PX
+};
+
+constexpr PerceptualTables BuildPerceptualTables()
+{
+    PerceptualTables t = {};
+    for (uint32_t i = 0; i <= PERCEPTUAL_LUT_SIZE; ++i)
+    {
+        const double u = (double)i / (double)PERCEPTUAL_LUT_SIZE;
+        t.DarkAdaptation[i] = (float)PerceptualCurves::DarkAdaptation(u * u);
+        t.ContrastMask[i]   = (float)PerceptualCurves::ContrastMask(u * u);
+        t.BlurMask[i]       = (float)PerceptualCurves::BlurMask(u);
+    }
+    return t;
+}
+
+static constexpr PerceptualTables PERCEPTUAL_TABLES = BuildPerceptualTables();
+
+// Entrada normalizada 0..1 (se satura fuera)
+constexpr float SamplePerceptualLut(const float (&lut)[PERCEPTUAL_LUT_SIZE + 1], float u)
+{
+    const float    pos   = std::min(std::max(u, 0.0f), 1.0f) * (float)PERCEPTUAL_LUT_SIZE;
+    const uint32_t index = std::min((uint32_t)pos, PERCEPTUAL_LUT_SIZE - 1);
+    const float    frac  = pos - (float)index;
+    return lut[index] + (lut[index + 1] - lut[index]) * frac;
+}
+
+// Error máximo de la interpolación frente a la curva, en 1/4, 1/2 y 3/4
+// de cada tramo de las tres tablas
+constexpr double PerceptualLutMaxError()
+{
+    double maxError = 0.0;
+    for (uint32_t i = 0; i < PERCEPTUAL_LUT_SIZE; ++i)
+    {
+        for (uint32_t q = 1; q < 4; ++q)
+        {
+            const double u = ((double)i + q * 0.25) / (double)PERCEPTUAL_LUT_SIZE;
+            const double e[3] =
+            {
+                SamplePerceptualLut(PERCEPTUAL_TABLES.DarkAdaptation, (float)u) - PerceptualCurves::DarkAdaptation(u * u),
+                SamplePerceptualLut(PERCEPTUAL_TABLES.ContrastMask, (float)u)   - PerceptualCurves::ContrastMask(u * u),
+                SamplePerceptualLut(PERCEPTUAL_TABLES.BlurMask, (float)u)       - PerceptualCurves::BlurMask(u)
+            };
+            for (double d : e)
+                maxError = std::max(maxError, PerceptualMath::Abs(d));
+        }
+    }
+    return maxError;
+}
+
+// Las series contra valores conocidos y las tablas contra las curvas
+static_assert(PerceptualMath::Abs(PerceptualMath::Exp(1.0) - 2.718281828459045) < 1e-9, "Exp constexpr impreciso");
+static_assert(PerceptualMath::Abs(PerceptualMath::Log(10.0) - 2.302585092994046) < 1e-9, "Log constexpr impreciso");
+static_assert(PerceptualMath::Abs(PerceptualMath::Sqrt(2.0) - 1.414213562373095) < 1e-9, "Sqrt constexpr impreciso");
+static_assert(PerceptualLutMaxError() < 0.005, "Tablas perceptuales demasiado gruesas");
+
+// Modelo perceptual: cada límite es Base * Π (1 + w[tipo][f] * x[f]).
+// Las respuestas no lineales se leen de las tablas constexpr con
+// interpolación lineal; el resto es un producto de polinomios.
+class PerceptualKernel
+{
+public:
+    enum Feature : uint32_t
+    {
+        Motion,          // velocidad de cámara
+        Glare,           // brillo: sombras menos críticas
+        Depth,           // foco lejano
+        DarkAdaptation,  // elevación del umbral de contraste con poca luz (adaptación del ojo)
+        ContrastMask,    // enmascaramiento por contraste local
+        BlurMask,        // enmascaramiento por motion blur
+        DepthOfField,    // fuera de foco
+        Periphery,       // atención concentrada: la periferia tolera más
+        Attention,       // saliencia alta en toda la pantalla: tolera menos
+        FeatureCount
+    };
+
+    static constexpr uint32_t TILE_BLOCK = 64;
+
+    static void Evaluate(const PerceptualState& p, float out[ERROR_TYPE_COUNT])
+    {
+        EvaluateTiles(&p, 1, out);
+    }
+
+    // Varios tiles (o vistas) a la vez. out es [tipo][tile]: out[t * count + i].
+    // Por bloques de TILE_BLOCK en SoA, los bucles internos recorren tiles
+    // contiguos con pesos constantes y el compilador los vectoriza.
+    static void EvaluateTiles(const PerceptualState* tiles, uint32_t count, float* out)
+    {
+        float x[FeatureCount][TILE_BLOCK];
+
+        for (uint32_t base = 0; base < count; base += TILE_BLOCK)
+        {
+            const uint32_t n = std::min(TILE_BLOCK, count - base);
+
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                const PerceptualState& p = tiles[base + i];
+                x[Motion][i]         = p.CameraVelocity;
+                x[Glare][i]          = p.Luminance;
+                x[Depth][i]          = p.FocusDepth;
+                x[DarkAdaptation][i] = std::sqrt(std::max(p.AdaptationLuminance, 0.0f));
+                x[ContrastMask][i]   = std::sqrt(std::max(p.Contrast, 0.0f));
+                x[BlurMask][i]       = p.MotionBlur / (float)PerceptualCurves::BLUR_RANGE_PX;
+                x[DepthOfField][i]   = p.DepthOfField;
+                x[Periphery][i]      = std::max(0.0f, p.SaliencyPeak - p.SaliencyMean);
+                x[Attention][i]      = p.SaliencyMean;
+            }
+
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                x[DarkAdaptation][i] = SamplePerceptualLut(PERCEPTUAL_TABLES.DarkAdaptation, x[DarkAdaptation][i]);
+                x[ContrastMask][i]   = SamplePerceptualLut(PERCEPTUAL_TABLES.ContrastMask, x[ContrastMask][i]);
+                x[BlurMask][i]       = SamplePerceptualLut(PERCEPTUAL_TABLES.BlurMask, x[BlurMask][i]);
+            }
+
+            for (uint32_t type = 0; type < ERROR_TYPE_COUNT; ++type)
+            {
+                float* scale = out + (size_t)type * count + base;
+                for (uint32_t i = 0; i < n; ++i)
+                    scale[i] = 1.0f;
+
+                for (uint32_t f = 0; f < FeatureCount; ++f)
+                {
+                    const float w = Weights[type][f];
+                    if (w == 0.0f)
+                        continue;
+                    for (uint32_t i = 0; i < n; ++i)
+                        scale[i] *= 1.0f + w * x[f][i];
+                }
+            }
+        }
+    }
+
+    // Referencia escalar con las curvas en coma flotante de la libm, sin
+    // tablas ni bloques. Mismas entradas saturadas que las tablas: sirve
+    // para medir el error y la ganancia de EvaluateTiles.
+    static void EvaluateReference(const PerceptualState& p, float out[ERROR_TYPE_COUNT])
+    {
+        const double luminance = std::min(std::max((double)p.AdaptationLuminance, 0.0), 1.0);
+        const double contrast  = std::min(std::max((double)p.Contrast, 0.0), 1.0);
+        const double blur      = std::min(std::max((double)p.MotionBlur / PerceptualCurves::BLUR_RANGE_PX, 0.0), 1.0);
+
+        const double cdm2  = 1.0 + luminance * 299.0;
+        const double full  = std::sqrt(1.0 + 20.0 / 300.0);
+        const double black = std::sqrt(1.0 + 20.0);
+
+        double x[FeatureCount];
+        x[Motion]         = p.CameraVelocity;
+        x[Glare]          = p.Luminance;
+        x[Depth]          = p.FocusDepth;
+        x[DarkAdaptation] = (std::sqrt(1.0 + 20.0 / cdm2) - full) / (black - full);
+        x[ContrastMask]   = std::pow(contrast, 0.7);
+        x[BlurMask]       = 1.0 - std::exp(-blur * PerceptualCurves::BLUR_RANGE_PX / 8.0);
+        x[DepthOfField]   = p.DepthOfField;
+        x[Periphery]      = std::max(0.0f, p.SaliencyPeak - p.SaliencyMean);
+        x[Attention]      = p.SaliencyMean;
+
+        for (uint32_t type = 0; type < ERROR_TYPE_COUNT; ++type)
+        {
+            double scale = 1.0;
+            for (uint32_t f = 0; f < FeatureCount; ++f)
+                scale *= 1.0 + Weights[type][f] * x[f];
+            out[type] = (float)scale;
+        }
+    }
+
+private:
+    // Motion Glare Depth Dark Contrast Blur DoF Periphery Attention
+    static constexpr float Weights[ERROR_TYPE_COUNT][FeatureCount] =
+    {
+        { 0.0f, 0.5f, 0.0f, 0.5f, 1.0f, 1.0f, 0.5f, 0.5f, -0.3f }, // Spatial
+        { 1.0f, 0.0f, 0.0f, 0.3f, 0.0f, 0.5f, 0.0f, 0.3f, -0.3f }, // Temporal
+        { 0.0f, 0.0f, 0.0f, 0.5f, 0.8f, 0.5f, 0.5f, 0.5f, -0.3f }, // Shading
+        { 0.0f, 0.0f, 1.0f, 0.3f, 0.5f, 0.5f, 0.8f, 0.5f, -0.3f }, // Reflection
+        { 0.0f, 0.0f, 0.0f, 0.5f, 0.3f, 0.8f, 0.5f, 0.3f, -0.2f }  // Volumetric
+    };
+};
+
+// Rasgos de un conjunto de tipos de error: el enum, cuántos hay, sus
+// límites base y cuál acumula en el tiempo (Count = ninguno).
+// Visual, simulación y audio comparten el mismo sistema sobre sus rasgos.
+struct VisualErrorTraits
+{
+    using Type = ErrorType;
+    static constexpr uint32_t Count         = ERROR_TYPE_COUNT;
+    static constexpr uint32_t TemporalIndex = (uint32_t)ErrorType::Temporal;
+
+    // Límites base (tuneables por plataforma)
+    static constexpr float BaseLimits[Count] =
+    {
+        1.0f, // Spatial
+        0.8f, // Temporal
+        0.6f, // Shading
+        0.5f, // Reflection
+        0.7f  // Volumetric
+    };
+};
+
+// Marca para scopes transaccionales (O(1))
+template<typename Traits>
+struct BasicErrorBudgetMark
+{
+    float Current[Traits::Count];
 };
 
 // Sistema principal
-class ErrorBudgetSystem
+template<typename Traits>
+class BasicErrorBudgetSystem
 {
 public:
-    ErrorBudgetSystem()
+    using Type = typename Traits::Type;
+    using Mark = BasicErrorBudgetMark<Traits>;
+
+    static constexpr uint32_t TYPE_COUNT   = Traits::Count;
+    static constexpr bool     HAS_TEMPORAL = Traits::TemporalIndex < Traits::Count;
+
+    BasicErrorBudgetSystem()
     {
         Reset();
     }
 
+    // Inicio de frame con los límites base. Con acumulación temporal,
+    // Temporal no empieza en cero sino con lo que aún se ve del error de
+    // frames anteriores.
     void Reset()
     {
-        for (uint32_t i = 0; i < ERROR_TYPE_COUNT; ++i)
+        const float carry = AdvanceTemporalHistory();
+
+        for (uint32_t i = 0; i < TYPE_COUNT; ++i)
+        {
+            Budgets[i].Current = 0.0f;
+            Budgets[i].Limit   = Traits::BaseLimits[i];
+        }
+
+        if constexpr (HAS_TEMPORAL)
         {
+            Budgets[Traits::TemporalIndex].Current = carry;
+            Budgets[Traits::TemporalIndex].Limit  *= TemporalGain;
+        }
+    }
+
+    // Inicio de frame (o de tick) conservando los límites ajustados
+    void BeginFrame()
+    {
+        const float carry = AdvanceTemporalHistory();
+
+        for (uint32_t i = 0; i < TYPE_COUNT; ++i)
             Budgets[i].Current = 0.0f;
-            Budgets[i].Limit   = BaseLimits[i];
+
+        if constexpr (HAS_TEMPORAL)
+            Budgets[Traits::TemporalIndex].Current = carry;
+    }
+
+    void SetLimit(Type type, float limit)
+    {
+        Budgets[(uint32_t)type].Limit = limit;
+    }
+
+    // El error temporal (reproyección, historia) sigue visible en los
+    // frames siguientes y se desvanece con 'decay' por frame durante
+    // 'window' frames. decay <= 0 desactiva la acumulación (por defecto).
+    // El límite pasa a ser sobre lo acumulado y se escala con la ganancia
+    // de la ventana: un cobro constante rinde lo mismo que sin acumulación,
+    // reutilizar varios frames seguidos se cobra compuesto y tras frames
+    // con poca reutilización queda margen para reutilizar más.
+    void SetTemporalAccumulation(float decay, uint32_t window = 8)
+    {
+        static_assert(HAS_TEMPORAL, "estos tipos de error no acumulan en el tiempo");
+
+        TemporalDecay  = std::min(std::max(decay, 0.0f), 0.99f);
+        TemporalWindow = std::min(std::max(window, 1u), ERROR_TEMPORAL_WINDOW_MAX);
+        TemporalHistory.fill(0.0f);
+        TemporalHead  = 0;
+        TemporalCarry = 0.0f;
+
+        float gain   = 0.0f;
+        float weight = 1.0f;
+        for (uint32_t age = 0; age < TemporalWindow && weight > 0.0f; ++age)
+        {
+            gain   += weight;
+            weight *= TemporalDecay;
         }
+
+        ErrorBudget& B = Budgets[Traits::TemporalIndex];
+        B.Limit     *= gain / TemporalGain;
+        B.Current    = 0.0f;
+        TemporalGain = gain;
     }
 
-    // Ajuste dinámico según percepción
+    // Parte de Current[Temporal] heredada de frames anteriores
+    float GetTemporalCarry() const
+    {
+        return TemporalCarry;
+    }
+
+    // Ajuste dinámico según percepción (los cinco límites visuales)
+    // Más movimiento = más tolerancia temporal; más brillo = sombras menos
+    // críticas; foco lejano = menos precisión en reflejos; contraste, blur
+    // y desenfoque enmascaran; la saliencia concentra la atención.
     void AdaptToPerception(const PerceptualState& p)
     {
-        // Más movimiento = más tolerancia temporal
-        Budgets[(uint32_t)ErrorType::Temporal].Limit =
-            BaseLimits[(uint32_t)ErrorType::Temporal] * (1.0f + p.CameraVelocity);
+        static_assert(std::is_same<Type, ErrorType>::value, "el modelo perceptual solo cubre el error visual");
+
+        float scale[TYPE_COUNT];
+        PerceptualKernel::Evaluate(p, scale);
 
-        // Más brillo = sombras menos críticas
-        Budgets[(uint32_t)ErrorType::Spatial].Limit =
-            BaseLimits[(uint32_t)ErrorType::Spatial] * (1.0f + p.Luminance * 0.5f);
+        for (uint32_t i = 0; i < TYPE_COUNT; ++i)
+            Budgets[i].Limit = Traits::BaseLimits[i] * scale[i];
 
-        // Profundidad lejana = menos precisión en reflejos
-        Budgets[(uint32_t)ErrorType::Reflection].Limit =
-            BaseLimits[(uint32_t)ErrorType::Reflection] * (1.0f + p.FocusDepth);
+        Budgets[Traits::TemporalIndex].Limit *= TemporalGain;
     }
 
     // Solicitud de error por subsistema
-    bool Request(ErrorType type, float amount)
+    bool Request(Type type, float amount)
     {
         ErrorBudget& B = Budgets[(uint32_t)type];
 
@@ -98,7 +502,7 @@ public:
     {
         float maxSat = 0.0f;
 
-        for (uint32_t i = 0; i < ERROR_TYPE_COUNT; ++i)
+        for (uint32_t i = 0; i < TYPE_COUNT; ++i)
         {
             maxSat = std::max(maxSat, Budgets[i].Current / Budgets[i].Limit);
         }
@@ -106,30 +510,198 @@ public:
         return maxSat;
     }
 
+    // Transacciones
+    Mark GetMark() const
+    {
+        Mark mark;
+        for (uint32_t i = 0; i < TYPE_COUNT; ++i)
+            mark.Current[i] = Budgets[i].Current;
+        return mark;
+    }
+
+    void Rollback(const Mark& mark)
+    {
+        for (uint32_t i = 0; i < TYPE_COUNT; ++i)
+            Budgets[i].Current = mark.Current[i];
+    }
+
+    // Sub-presupuesto de un worker: su parte del error restante por tipo
+    // overcommit > 1 reparte más de lo que queda (el Join puede exceder Limit)
+    void ForkWorker(uint32_t workerIndex, uint32_t workerCount, BasicErrorBudgetSystem& worker,
+                    float overcommit = 1.0f) const
+    {
+        (void)workerIndex;
+        for (uint32_t i = 0; i < TYPE_COUNT; ++i)
+        {
+            const float remaining = std::max(0.0f, Budgets[i].Limit - Budgets[i].Current);
+            worker.Budgets[i].Current = 0.0f;
+            worker.Budgets[i].Limit   = remaining * overcommit / (float)workerCount;
+        }
+    }
+
+    // Integra lo confirmado por un worker
+    void Join(const BasicErrorBudgetSystem& worker)
+    {
+        for (uint32_t i = 0; i < TYPE_COUNT; ++i)
+            Budgets[i].Current += worker.Budgets[i].Current;
+    }
+
+    float GetRemaining(Type type) const
+    {
+        const ErrorBudget& B = Budgets[(uint32_t)type];
+        return std::max(0.0f, B.Limit - B.Current);
+    }
+
     // Debug / Telemetría
-    float GetUsage(ErrorType type) const
+    float GetUsage(Type type) const
     {
         return Budgets[(uint32_t)type].Current / Budgets[(uint32_t)type].Limit;
     }
 
 private:
-    ErrorBudget Budgets[ERROR_TYPE_COUNT];
+    // Guarda el error temporal nuevo del frame que termina y devuelve
+    // la suma decaída de la ventana (edades 1..window-1)
+    float AdvanceTemporalHistory()
+    {
+        if constexpr (!HAS_TEMPORAL)
+            return 0.0f;
+        else
+        {
+            if (TemporalDecay <= 0.0f)
+                return 0.0f;
 
-    // Límites base (tuneables por plataforma)
-    static constexpr float BaseLimits[ERROR_TYPE_COUNT] =
+            const float spent = Budgets[Traits::TemporalIndex].Current - TemporalCarry;
+            TemporalHead = (TemporalHead + 1) % ERROR_TEMPORAL_WINDOW_MAX;
+            TemporalHistory[TemporalHead] = std::max(0.0f, spent);
+
+            float carry  = 0.0f;
+            float weight = TemporalDecay;
+            for (uint32_t age = 1; age < TemporalWindow; ++age)
+            {
+                const uint32_t slot = (TemporalHead + ERROR_TEMPORAL_WINDOW_MAX + 1 - age) % ERROR_TEMPORAL_WINDOW_MAX;
+                carry  += TemporalHistory[slot] * weight;
+                weight *= TemporalDecay;
+            }
+
+            TemporalCarry = carry;
+            return carry;
+        }
+    }
+
+    ErrorBudget Budgets[TYPE_COUNT];
+
+    // Acumulación temporal (desactivada por defecto)
+    std::array<float, ERROR_TEMPORAL_WINDOW_MAX> TemporalHistory = {};
+    uint32_t TemporalHead   = 0;
+    uint32_t TemporalWindow = 1;
+    float    TemporalDecay  = 0.0f;
+    float    TemporalGain   = 1.0f;
+    float    TemporalCarry  = 0.0f;
+};
+
+// Scope especulativo: deshace sus peticiones al salir salvo Commit
+template<typename Traits>
+class BasicErrorBudgetScope
+{
+public:
+    explicit BasicErrorBudgetScope(BasicErrorBudgetSystem<Traits>& system)
+        : System(system), Mark(system.GetMark()), Open(true)
     {
-        1.0f, // Spatial
-        0.8f, // Temporal
-        0.6f, // Shading
-        0.5f, // Reflection
-        0.7f  // Volumetric
-    };
+    }
+
+    ~BasicErrorBudgetScope()
+    {
+        Rollback();
+    }
+
+    BasicErrorBudgetScope(const BasicErrorBudgetScope&) = delete;
+    BasicErrorBudgetScope& operator=(const BasicErrorBudgetScope&) = delete;
+
+    void Commit()
+    {
+        Open = false;
+    }
+
+    void Rollback()
+    {
+        if (Open)
+            System.Rollback(Mark);
+        Open = false;
+    }
+
+private:
+    BasicErrorBudgetSystem<Traits>& System;
+    BasicErrorBudgetMark<Traits>    Mark;
+    bool                            Open;
 };
 
+using ErrorBudgetSystem = BasicErrorBudgetSystem<VisualErrorTraits>;
+using ErrorBudgetMark   = BasicErrorBudgetMark<VisualErrorTraits>;
+using ErrorBudgetScope  = BasicErrorBudgetScope<VisualErrorTraits>;
+
+
+// Benchmark del modelo perceptual: tablas + bloques SoA frente a la
+// referencia escalar con la libm, en ns por tile, y error relativo máximo
+// de los límites (escalas) entre ambas.
+struct PerceptualKernelBenchmarkResult
+{
+    double KernelNsPerTile;
+    double ReferenceNsPerTile;
+    float  MaxRelativeError;
+};
+
+inline PerceptualKernelBenchmarkResult RunPerceptualKernelBenchmark(const PerceptualState* tiles, uint32_t count,
+                                                                    uint32_t iterations)
+{
+    PerceptualKernelBenchmarkResult result = {};
+    if (count == 0)
+        return result;
+
+    iterations = std::max<uint32_t>(1, iterations);
+    std::vector<float> kernel((size_t)ERROR_TYPE_COUNT * count);
+    std::vector<float> reference((size_t)ERROR_TYPE_COUNT * count);
+
+    // El checksum evita que el compilador descarte vueltas enteras
+    volatile float sink = 0.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t it = 0; it < iterations; ++it)
+    {
+        PerceptualKernel::EvaluateTiles(tiles, count, kernel.data());
+        sink = sink + kernel[it % kernel.size()];
+    }
+    result.KernelNsPerTile = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                           / ((double)iterations * count);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t it = 0; it < iterations; ++it)
+    {
+        float scale[ERROR_TYPE_COUNT];
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            PerceptualKernel::EvaluateReference(tiles[i], scale);
+            for (uint32_t t = 0; t < ERROR_TYPE_COUNT; ++t)
+                reference[(size_t)t * count + i] = scale[t];
+        }
+        sink = sink + reference[it % reference.size()];
+    }
+    result.ReferenceNsPerTile = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                              / ((double)iterations * count);
+
+    for (size_t i = 0; i < kernel.size(); ++i)
+    {
+        const float error = std::fabs(kernel[i] - reference[i]) / std::max(std::fabs(reference[i]), 1e-6f);
+        result.MaxRelativeError = std::max(result.MaxRelativeError, error);
+    }
+    return result;
+}
 
 // Ejemplo de uso
 // if (ErrorSystem.Request(ErrorType::Spatial, lodError))
 //     ApplyLOD();
 // else
 //     IncreaseLOD();
+//
+// ErrorSystem.SetTemporalAccumulation(0.6f);   // la historia se refresca ~40% por frame
+// ErrorSystem.Reset();                         // cada frame: arrastra el error reutilizado
 }
@@ -1,3 +1,5 @@
+#pragma once
+
 // Objetivo:
 // Establecer un presupuesto estricto de memoria por frame,
 // evitando picos, fragmentación y comportamiento no determinista.
@@ -10,6 +12,17 @@
 
 #include <cstdint>
 #include <cstring>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace TX
 {
@@ -17,6 +30,9 @@ namespace TX
 constexpr uint64_t KB = 1024;
 constexpr uint64_t MB = 1024 * KB;
 
+constexpr uint64_t FRAME_MEMORY_PAGE_SIZE      = 4 * KB;
+constexpr uint64_t FRAME_MEMORY_HUGE_PAGE_SIZE = 2 * MB;
+
 // Categorías de gasto por frame
 enum class FrameMemoryDomain : uint8_t
 {
@@ -31,11 +47,104 @@ enum class FrameMemoryDomain : uint8_t
     Count
 };
 
+// Política de admisión por dominio
+enum class FrameMemoryPolicy : uint8_t
+{
+    Linear,     // admite contra lo consumido en el frame (bump)
+    Stack       // admite contra lo vivo: pilas y free-lists que liberan dentro del frame
+};
+
 // Presupuesto por dominio
 struct FrameMemoryBudget
 {
     uint64_t MaxBytes;
-    uint64_t UsedBytes;
+    uint64_t UsedBytes;   // acumulado del frame (nunca baja)
+    uint64_t LiveBytes;   // vivo ahora (baja con Release)
+    uint64_t PeakBytes;   // máximo de LiveBytes en el frame
+};
+
+// Memoria de respaldo (opcional)
+// Sin respaldo el sistema solo contabiliza; con respaldo cada dominio
+// tiene una región real reservada, pre-fallada y, si se puede, bloqueada.
+// Así el primer acceso dentro del frame nunca provoca un fallo de página.
+struct FrameMemoryBackingDesc
+{
+    bool UseHugePages  = true;   // MADV_HUGEPAGE (THP)
+    bool PreFault      = true;   // poblar todas las páginas antes del primer frame
+    bool PreFaultAsync = true;   // poblar en un hilo de fondo
+    bool Lock          = false;  // mlock (si RLIMIT_MEMLOCK lo permite)
+
+    // Devolución de páginas ociosas: al cerrar cada ventana de N frames
+    // se liberan las páginas sobre el máximo de esa ventana.
+    uint32_t DecommitQuietFrames = 0;     // 0 = nunca devolver
+    bool     DecommitLazyFree    = false; // MADV_FREE en lugar de MADV_DONTNEED
+
+    // Nodo NUMA de las páginas (mbind MPOL_BIND); -1 = política del sistema
+    int32_t NumaNode = -1;
+};
+
+// Telemetría del respaldo (válida tras WaitForBacking)
+struct FrameMemoryBackingStats
+{
+    uint64_t ReservedBytes;
+    double   ReserveMs;     // mmap + madvise
+    double   PreFaultMs;    // población de páginas (hilo de fondo incluido)
+    uint64_t MinorFaults;   // fallos durante la población
+    uint64_t MajorFaults;
+    bool     HugePages;     // madvise(MADV_HUGEPAGE) aceptado
+    bool     Locked;        // mlock aceptado
+    bool     NumaBound;     // mbind al nodo pedido aceptado
+};
+
+// Evictor: libera asignaciones de poco valor del dominio (poses cacheadas,
+// partículas lejanas...) y devuelve los bytes liberados.
+// Solo se invoca en dominios Stack: en un bump lo liberado no se
+// reutiliza hasta el siguiente frame.
+// No debe pedir memoria al mismo sistema.
+using FrameMemoryEvictFn = uint64_t (*)(void* userData, FrameMemoryDomain domain, uint64_t bytesNeeded);
+
+struct FrameMemoryEvictor
+{
+    FrameMemoryEvictFn Evict;
+    void*              UserData;
+    float              Cost;       // menor coste = se invoca antes
+};
+
+constexpr uint32_t FRAME_MEMORY_MAX_EVICTORS = 8;
+
+// Previsión de demanda por dominio
+constexpr uint32_t FRAME_MEMORY_FORECAST_BINS  = 8;      // tramos de progreso del frame
+constexpr float    FRAME_MEMORY_FORECAST_ALPHA = 0.1f;   // peso EWMA de cada frame nuevo
+
+struct FrameMemoryForecast
+{
+    float FinalUsage;                            // EWMA del uso al final del frame
+    float Shape[FRAME_MEMORY_FORECAST_BINS];     // fracción del final gastada en cada tramo
+    float Samples[FRAME_MEMORY_FORECAST_BINS];   // máximo uso observado en cada tramo (-1 = sin dato)
+    float ErrorEwma;                             // error absoluto medio de la previsión a mitad de frame
+    bool  HasHistory;
+};
+
+// Marca de contadores para scopes transaccionales
+// Guardar y restaurar es O(1): un puñado de enteros por dominio,
+// igual que rebobinar un bump allocator.
+struct FrameMemoryMark
+{
+    uint64_t UsedBytes[(uint8_t)FrameMemoryDomain::Count];
+    uint64_t LiveBytes[(uint8_t)FrameMemoryDomain::Count];
+    uint64_t Cursors[(uint8_t)FrameMemoryDomain::Count];
+    uint64_t EvictedBytes[(uint8_t)FrameMemoryDomain::Count];
+};
+
+// Región real de un dominio
+struct FrameMemoryArena
+{
+    uint8_t* Base;
+    uint64_t Cursor;
+    uint64_t FramePeak;     // máximo del cursor en el frame (Free y Rollback lo bajan)
+    uint64_t Committed;     // bytes con páginas residentes
+    uint64_t WindowPeak;    // máximo del cursor en la ventana actual
+    uint32_t WindowFrames;  // frames transcurridos de la ventana actual
 };
 
 // Sistema principal
@@ -47,50 +156,248 @@ public:
         Reset();
     }
 
+    ~FrameMemoryBudgetSystem()
+    {
+        ReleaseBacking();
+    }
+
+    FrameMemoryBudgetSystem(const FrameMemoryBudgetSystem&) = delete;
+    FrameMemoryBudgetSystem& operator=(const FrameMemoryBudgetSystem&) = delete;
+
     // Inicialización con presupuesto total del frame
     void Initialize(uint64_t totalFrameBudget)
     {
+        ReleaseBacking();
         TotalBudget = totalFrameBudget;
 
         // Distribución base (ajustable por plataforma)
-        Budgets[(uint8_t)FrameMemoryDomain::Geometry]   = { totalFrameBudget * 30 / 100, 0 };
-        Budgets[(uint8_t)FrameMemoryDomain::Textures]   = { totalFrameBudget * 25 / 100, 0 };
-        Budgets[(uint8_t)FrameMemoryDomain::Animation]  = { totalFrameBudget * 10 / 100, 0 };
-        Budgets[(uint8_t)FrameMemoryDomain::Particles]  = { totalFrameBudget * 8  / 100, 0 };
-        Budgets[(uint8_t)FrameMemoryDomain::Physics]    = { totalFrameBudget * 8  / 100, 0 };
-        Budgets[(uint8_t)FrameMemoryDomain::AI]         = { totalFrameBudget * 7  / 100, 0 };
-        Budgets[(uint8_t)FrameMemoryDomain::Audio]      = { totalFrameBudget * 6  / 100, 0 };
-        Budgets[(uint8_t)FrameMemoryDomain::UI]         = { totalFrameBudget * 6  / 100, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Geometry]   = { totalFrameBudget * 30 / 100, 0, 0, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Textures]   = { totalFrameBudget * 25 / 100, 0, 0, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Animation]  = { totalFrameBudget * 10 / 100, 0, 0, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Particles]  = { totalFrameBudget * 8  / 100, 0, 0, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Physics]    = { totalFrameBudget * 8  / 100, 0, 0, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::AI]         = { totalFrameBudget * 7  / 100, 0, 0, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Audio]      = { totalFrameBudget * 6  / 100, 0, 0, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::UI]         = { totalFrameBudget * 6  / 100, 0, 0, 0 };
+    }
+
+    // Inicialización con memoria de respaldo real
+    void Initialize(uint64_t totalFrameBudget, const FrameMemoryBackingDesc& backing)
+    {
+        Initialize(totalFrameBudget);
+        ReserveBacking(backing);
     }
 
     // Reinicio por frame
     void BeginFrame(){
+        const bool manageCommit = Backing.DecommitQuietFrames > 0 && IsBackingReady();
+
+        UpdateForecasts();
+
+        if (manageCommit)
+        {
+            for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+                UpdateCommit(i);
+        }
+
+        Clear();
+        TickFrameProgress();
+    }
+
+    // Vacía contadores y cursores sin cerrar un frame: no aprende la
+    // previsión ni toca páginas. Para vidas que no son frames.
+    void Clear(){
         for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+        {
             Budgets[i].UsedBytes = 0;
+            Budgets[i].LiveBytes = 0;
+            Budgets[i].PeakBytes = 0;
+            Arenas[i].Cursor     = 0;
+            Arenas[i].FramePeak  = 0;
+            EvictedBytes[i]      = 0;
+        }
     }
 
     // Solicitud de memoria
+    // Si no cabe, los evictores del dominio intentan hacer sitio.
     bool Request(FrameMemoryDomain domain, uint64_t bytes){
         FrameMemoryBudget& budget = Budgets[(uint8_t)domain];
-        
-        if (budget.UsedBytes + bytes > budget.MaxBytes)
+
+        if (GetAdmittedBytes(domain) + bytes > budget.MaxBytes && !Evict(domain, bytes))
             return false;
 
         budget.UsedBytes += bytes;
+        budget.LiveBytes += bytes;
+        if (budget.LiveBytes > budget.PeakBytes)
+            budget.PeakBytes = budget.LiveBytes;
+
+        RecordSample(domain);
         return true;
     }
 
+    // Liberación dentro del frame (solo amplía la cuota en dominios Stack)
+    void Release(FrameMemoryDomain domain, uint64_t bytes){
+        FrameMemoryBudget& budget = Budgets[(uint8_t)domain];
+        budget.LiveBytes -= (bytes < budget.LiveBytes) ? bytes : budget.LiveBytes;
+    }
+
+    // Evictores por dominio, ordenados por coste. Solo en dominios Stack
+    // (SetPolicy antes de registrar): en Linear liberar no devuelve cuota
+    // y el evictor nunca se llamaría, así que se rechaza.
+    bool RegisterEvictor(FrameMemoryDomain domain, FrameMemoryEvictFn evict, void* userData, float cost)
+    {
+        const uint8_t d = (uint8_t)domain;
+        uint32_t& count = EvictorCounts[d];
+        if (Policies[d] != FrameMemoryPolicy::Stack || count >= FRAME_MEMORY_MAX_EVICTORS)
+            return false;
+
+        uint32_t slot = count++;
+        while (slot > 0 && Evictors[d][slot - 1].Cost > cost)
+        {
+            Evictors[d][slot] = Evictors[d][slot - 1];
+            --slot;
+        }
+
+        Evictors[d][slot] = { evict, userData, cost };
+        return true;
+    }
+
+    void UnregisterEvictor(FrameMemoryDomain domain, FrameMemoryEvictFn evict, void* userData)
+    {
+        const uint8_t d = (uint8_t)domain;
+        uint32_t& count = EvictorCounts[d];
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (Evictors[d][i].Evict != evict || Evictors[d][i].UserData != userData)
+                continue;
+
+            for (uint32_t j = i + 1; j < count; ++j)
+                Evictors[d][j - 1] = Evictors[d][j];
+            --count;
+            return;
+        }
+    }
+
+    // Cota de trabajo de expulsión por petición (llamadas a evictores)
+    void SetMaxEvictionCalls(uint32_t calls){
+        MaxEvictionCalls = calls;
+    }
+
+    uint64_t GetEvictedBytes(FrameMemoryDomain domain) const{
+        return EvictedBytes[(uint8_t)domain];
+    }
+
+    // Pasar a Linear descarta los evictores del dominio
+    void SetPolicy(FrameMemoryDomain domain, FrameMemoryPolicy policy){
+        Policies[(uint8_t)domain] = policy;
+        if (policy != FrameMemoryPolicy::Stack)
+            EvictorCounts[(uint8_t)domain] = 0;
+    }
+
+    FrameMemoryPolicy GetPolicy(FrameMemoryDomain domain) const{
+        return Policies[(uint8_t)domain];
+    }
+
+    // Solicitud con memoria real (bump dentro de la región del dominio)
+    // Devuelve nullptr sin respaldo o si el dominio no tiene cuota.
+    // Se cobra solo el bloque: el relleno de alineación queda bajo el
+    // cursor como fragmentación y Free devuelve exactamente lo cobrado.
+    void* Allocate(FrameMemoryDomain domain, uint64_t bytes, uint64_t alignment = 16)
+    {
+        FrameMemoryArena& arena = Arenas[(uint8_t)domain];
+        if (!arena.Base)
+            return nullptr;
+
+        const uint64_t offset = AlignUp(arena.Cursor, alignment);
+        const uint64_t end    = offset + bytes;
+        if (end > Budgets[(uint8_t)domain].MaxBytes)
+            return nullptr;
+
+        if (!Request(domain, bytes))
+            return nullptr;
+
+        arena.Cursor = end;
+        if (end > arena.FramePeak)
+            arena.FramePeak = end;
+        return arena.Base + offset;
+    }
+
+    // El puntero pertenece a la región del dominio
+    bool Contains(FrameMemoryDomain domain, const void* ptr) const
+    {
+        const FrameMemoryArena& arena = Arenas[(uint8_t)domain];
+        const uint8_t* block = static_cast<const uint8_t*>(ptr);
+        return arena.Base && block >= arena.Base && block < arena.Base + Budgets[(uint8_t)domain].MaxBytes;
+    }
+
+    // Devolución de un bloque de Allocate; si es la cima del dominio
+    // el cursor retrocede (uso LIFO en dominios Stack)
+    void Free(FrameMemoryDomain domain, void* ptr, uint64_t bytes)
+    {
+        FrameMemoryArena& arena = Arenas[(uint8_t)domain];
+        uint8_t* block = static_cast<uint8_t*>(ptr);
+
+        if (arena.Base && block + bytes == arena.Base + arena.Cursor)
+            arena.Cursor = (uint64_t)(block - arena.Base);
+
+        Release(domain, bytes);
+    }
+
     // Consulta de estado
     uint64_t GetRemaining(FrameMemoryDomain domain) const{
         const FrameMemoryBudget& budget = Budgets[(uint8_t)domain];
-        return (budget.MaxBytes > budget.UsedBytes)
-             ? (budget.MaxBytes - budget.UsedBytes)
+        const uint64_t admitted = GetAdmittedBytes(domain);
+        return (budget.MaxBytes > admitted)
+             ? (budget.MaxBytes - admitted)
              : 0;
     }
 
+    // Mayor bloque contiguo que Allocate puede servir. En el bump solo
+    // hay hueco sobre el cursor: lo liberado por debajo de la cima
+    // cuenta en GetRemaining pero no es contiguo. Sin respaldo no hay
+    // fragmentación y coincide con GetRemaining.
+    uint64_t GetLargestFreeBlock(FrameMemoryDomain domain) const{
+        const FrameMemoryArena& arena = Arenas[(uint8_t)domain];
+        const uint64_t remaining = GetRemaining(domain);
+        if (!arena.Base)
+            return remaining;
+
+        const uint64_t maxBytes = Budgets[(uint8_t)domain].MaxBytes;
+        const uint64_t above    = (maxBytes > arena.Cursor) ? maxBytes - arena.Cursor : 0;
+        return (above < remaining) ? above : remaining;
+    }
+
+    // 0 = todo lo restante es contiguo, 1 = restante inservible
+    float GetFragmentation(FrameMemoryDomain domain) const{
+        const uint64_t remaining = GetRemaining(domain);
+        return remaining ? 1.0f - (float)GetLargestFreeBlock(domain) / (float)remaining : 0.0f;
+    }
+
+    // Bytes que cuentan para la admisión según la política del dominio
+    uint64_t GetAdmittedBytes(FrameMemoryDomain domain) const{
+        const FrameMemoryBudget& budget = Budgets[(uint8_t)domain];
+        return (Policies[(uint8_t)domain] == FrameMemoryPolicy::Stack)
+             ? budget.LiveBytes
+             : budget.UsedBytes;
+    }
+
+    uint64_t GetLiveBytes(FrameMemoryDomain domain) const{ return Budgets[(uint8_t)domain].LiveBytes; }
+    uint64_t GetPeakBytes(FrameMemoryDomain domain) const{ return Budgets[(uint8_t)domain].PeakBytes; }
+
     float GetUsageRatio(FrameMemoryDomain domain) const{
         const FrameMemoryBudget& budget = Budgets[(uint8_t)domain];
-        return (float)budget.UsedBytes / (float)budget.MaxBytes;
+        return (float)GetAdmittedBytes(domain) / (float)budget.MaxBytes;
+    }
+
+    float GetLiveRatio(FrameMemoryDomain domain) const{
+        const FrameMemoryBudget& budget = Budgets[(uint8_t)domain];
+        return (float)budget.LiveBytes / (float)budget.MaxBytes;
+    }
+
+    float GetPeakRatio(FrameMemoryDomain domain) const{
+        const FrameMemoryBudget& budget = Budgets[(uint8_t)domain];
+        return (float)budget.PeakBytes / (float)budget.MaxBytes;
     }
 
     // Evaluación de riesgo
@@ -98,23 +405,732 @@ public:
         return GetUsageRatio(domain) > 0.9f;
     }
 
+    // Uso previsto al final del frame (ratio como GetUsageRatio).
+    // Combina la extrapolación del ritmo actual, corregida con la forma
+    // histórica del frame, y el EWMA del uso final; cuanto más avanzado
+    // el frame, más pesa lo observado. Consulta pura: las muestras las
+    // toma Request en el tramo fijado por el último tick de progreso y el
+    // aprendizaje ocurre en BeginFrame.
+    float PredictedUsage(FrameMemoryDomain domain) const{
+        return PredictedUsage(domain, GetFrameProgress());
+    }
+
+    float PredictedUsage(FrameMemoryDomain domain, float progress) const{
+        return Predict(Forecasts[(uint8_t)domain], GetUsageRatio(domain), progress);
+    }
+
+    bool IsDomainPredictedCritical(FrameMemoryDomain domain) const{
+        return PredictedUsage(domain) > 0.9f;
+    }
+
+    // Progreso estimado del frame actual según la duración media
+    float GetFrameProgress() const{
+        if (ProgressOverride >= 0.0f)
+            return ProgressOverride;
+        if (FrameDurationMs <= 0.0f)
+            return 0.0f;
+
+        const float elapsed = (float)ElapsedMs(FrameStart);
+        return (elapsed < FrameDurationMs) ? elapsed / FrameDurationMs : 1.0f;
+    }
+
+    // Progreso impuesto (repeticiones de trazas, frames con tiempo fijo);
+    // negativo vuelve a estimarlo con el reloj
+    void SetFrameProgress(float progress){
+        ProgressOverride = progress;
+        TickFrameProgress();
+    }
+
+    // Fija el tramo de previsión en el que Request anota sus muestras.
+    // Request no lee el reloj: el motor llama a esto en las fronteras de
+    // fase del frame (tras simulación, tras culling...); BeginFrame y
+    // SetFrameProgress también lo hacen. Sin ticks todo cae en el tramo 0.
+    void TickFrameProgress(){
+        SampleBin = (ProgressOverride >= 0.0f || FrameDurationMs > 0.0f)
+                  ? (int32_t)ForecastBin(GetFrameProgress())
+                  : -1;
+    }
+
+    // Precisión de la previsión a mitad de frame (error absoluto medio en ratio)
+    float GetForecastError(FrameMemoryDomain domain) const{
+        return Forecasts[(uint8_t)domain].ErrorEwma;
+    }
+
     // Presupuesto total restante
     uint64_t GetTotalRemaining() const{
         uint64_t used = 0;
         for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
-            used += Budgets[i].UsedBytes;
+            used += GetAdmittedBytes((FrameMemoryDomain)i);
 
         return (TotalBudget > used) ? (TotalBudget - used) : 0;
     }
 
+    // Transacciones
+    FrameMemoryMark GetMark() const
+    {
+        FrameMemoryMark mark;
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+        {
+            mark.UsedBytes[i] = Budgets[i].UsedBytes;
+            mark.LiveBytes[i] = Budgets[i].LiveBytes;
+            mark.Cursors[i]      = Arenas[i].Cursor;
+            mark.EvictedBytes[i] = EvictedBytes[i];
+        }
+        return mark;
+    }
+
+    // Deshace todo lo pedido desde la marca (el pico se conserva:
+    // esas páginas ya se tocaron). Lo desalojado desde la marca no
+    // vuelve: los evictores ya liberaron esas asignaciones, así que se
+    // descuenta de lo vivo restaurado.
+    void Rollback(const FrameMemoryMark& mark)
+    {
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+        {
+            const uint64_t evicted = EvictedBytes[i] - mark.EvictedBytes[i];
+
+            Budgets[i].UsedBytes = mark.UsedBytes[i];
+            Budgets[i].LiveBytes = mark.LiveBytes[i] - ((evicted < mark.LiveBytes[i]) ? evicted : mark.LiveBytes[i]);
+            Arenas[i].Cursor     = mark.Cursors[i];
+        }
+    }
+
+    // Sub-presupuesto de un worker: su parte de lo que queda en cada dominio.
+    // El worker especula con sus propios scopes sin tocar este sistema
+    // (solo contabiliza, no tiene respaldo).
+    // overcommit > 1 reparte más de lo que queda: el Join puede no caber
+    // y hay que reconciliar (ver TXParallelBudget)
+    void ForkWorker(uint32_t workerIndex, uint32_t workerCount, FrameMemoryBudgetSystem& worker,
+                    float overcommit = 1.0f) const
+    {
+        worker.Reset();
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+        {
+            const uint64_t remaining = (overcommit != 1.0f)
+                                     ? (uint64_t)((double)GetRemaining((FrameMemoryDomain)i) * overcommit)
+                                     : GetRemaining((FrameMemoryDomain)i);
+            const uint64_t share = remaining / workerCount
+                                 + ((workerIndex < remaining % workerCount) ? 1 : 0);
+
+            worker.Budgets[i]   = { share, 0, 0, 0 };
+            worker.Policies[i]  = Policies[i];
+            worker.TotalBudget += share;
+        }
+    }
+
+    // Integra lo confirmado por un worker (cabe por construcción sin overcommit)
+    void Join(const FrameMemoryBudgetSystem& worker)
+    {
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+        {
+            FrameMemoryBudget& budget = Budgets[i];
+            budget.UsedBytes += worker.Budgets[i].UsedBytes;
+            budget.LiveBytes += worker.Budgets[i].LiveBytes;
+            if (budget.LiveBytes > budget.PeakBytes)
+                budget.PeakBytes = budget.LiveBytes;
+        }
+    }
+
+    // Estado del respaldo
+    bool HasBacking() const { return MappedBase != nullptr; }
+    bool IsBackingReady() const { return BackingReady.load(std::memory_order_acquire); }
+
+    uint64_t GetCommittedBytes(FrameMemoryDomain domain) const
+    {
+        return Arenas[(uint8_t)domain].Committed;
+    }
+
+    // Espera al pre-fault en segundo plano (llamar antes del primer frame crítico)
+    void WaitForBacking()
+    {
+        if (PreFaultThread.joinable())
+            PreFaultThread.join();
+    }
+
+    const FrameMemoryBackingStats& GetBackingStats()
+    {
+        WaitForBacking();
+        return Stats;
+    }
+
     void Reset()
     {
+        ReleaseBacking();
         std::memset(Budgets, 0, sizeof(Budgets));
+        std::memset(Policies, 0, sizeof(Policies));
+        std::memset(Evictors, 0, sizeof(Evictors));
+        std::memset(EvictorCounts, 0, sizeof(EvictorCounts));
+        std::memset(EvictedBytes, 0, sizeof(EvictedBytes));
         TotalBudget = 0;
+        ResetForecasts();
     }
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    static double ElapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void ReserveBacking(const FrameMemoryBackingDesc& desc)
+    {
+        const Clock::time_point start = Clock::now();
+        const uint64_t pageSize = desc.UseHugePages ? FRAME_MEMORY_HUGE_PAGE_SIZE
+                                                    : FRAME_MEMORY_PAGE_SIZE;
+        Backing         = desc;
+        BackingPageSize = pageSize;
+
+        // Cada dominio empieza en frontera de página para poder
+        // gestionar sus páginas por separado
+        uint64_t offsets[(uint8_t)FrameMemoryDomain::Count];
+        uint64_t total = 0;
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+        {
+            offsets[i] = total;
+            total     += AlignUp(Budgets[i].MaxBytes, pageSize);
+        }
+
+        if (total == 0)
+            return;
+
+        uint8_t* base = nullptr;
+
+#if defined(__linux__)
+        // Margen extra para alinear el inicio a huge page
+        const uint64_t mapBytes = total + (desc.UseHugePages ? pageSize : 0);
+        void* mapped = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mapped == MAP_FAILED)
+            return;
+
+        MappedBase  = mapped;
+        MappedBytes = mapBytes;
+        base = reinterpret_cast<uint8_t*>(AlignUp(reinterpret_cast<uintptr_t>(mapped), pageSize));
+
+        if (desc.UseHugePages)
+            Stats.HugePages = madvise(base, total, MADV_HUGEPAGE) == 0;
+
+        // Antes de poblar: las páginas nacen ya en el nodo pedido.
+        // Syscall directa para no depender de libnuma.
+#if defined(SYS_mbind)
+        if (desc.NumaNode >= 0 && desc.NumaNode < 64)
+        {
+            const unsigned long nodeMask = 1ul << desc.NumaNode;
+            const int mpolBind = 2;   // MPOL_BIND
+            // maxnode = bits de la máscara + 1: el kernel descuenta uno
+            const unsigned long maxNode = sizeof(nodeMask) * 8 + 1;
+            Stats.NumaBound = syscall(SYS_mbind, base, total, mpolBind, &nodeMask, maxNode, 0u) == 0;
+        }
+#endif
+#else
+        base = static_cast<uint8_t*>(::operator new(total, std::align_val_t(FRAME_MEMORY_PAGE_SIZE), std::nothrow));
+        if (!base)
+            return;
+
+        MappedBase  = base;
+        MappedBytes = total;
+#endif
+
+        const bool populate = desc.PreFault || desc.Lock;
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+        {
+            const uint64_t regionBytes = AlignUp(Budgets[i].MaxBytes, pageSize);
+            Arenas[i] = { base + offsets[i], 0, 0, populate ? regionBytes : 0, 0, 0 };
+        }
+
+        Stats.ReservedBytes = total;
+        Stats.ReserveMs     = ElapsedMs(start);
+
+        if (!populate)
+        {
+            BackingReady.store(true, std::memory_order_release);
+            return;
+        }
+
+        if (desc.PreFaultAsync)
+            PreFaultThread = std::thread(&FrameMemoryBudgetSystem::PreFault, this, base, total, desc.Lock);
+        else
+            PreFault(base, total, desc.Lock);
+    }
+
+    // Población de páginas sin alterar el contenido: los subsistemas
+    // pueden usar la región mientras el hilo de fondo sigue trabajando.
+    void PreFault(uint8_t* base, uint64_t bytes, bool lock)
+    {
+        const Clock::time_point start = Clock::now();
+
+#if defined(__linux__)
+        rusage before = {};
+        getrusage(RUSAGE_THREAD, &before);
+
+        // mlock ya puebla la región; si no hay permiso se cae a madvise/toque
+        bool populated = lock && mlock(base, bytes) == 0;
+        Stats.Locked = populated;
+
+#if defined(MADV_POPULATE_WRITE)
+        if (!populated)
+            populated = madvise(base, bytes, MADV_POPULATE_WRITE) == 0;
+#endif
+
+        if (!populated)
+        {
+            for (uint64_t offset = 0; offset < bytes; offset += FRAME_MEMORY_PAGE_SIZE)
+                __atomic_fetch_add(base + offset, 0, __ATOMIC_RELAXED);
+        }
+
+        rusage after = {};
+        getrusage(RUSAGE_THREAD, &after);
+        Stats.MinorFaults = (uint64_t)(after.ru_minflt - before.ru_minflt);
+        Stats.MajorFaults = (uint64_t)(after.ru_majflt - before.ru_majflt);
+#else
+        (void)lock;
+        for (uint64_t offset = 0; offset < bytes; offset += FRAME_MEMORY_PAGE_SIZE)
+            reinterpret_cast<volatile uint8_t*>(base)[offset] = base[offset];
+#endif
+
+        Stats.PreFaultMs = ElapsedMs(start);
+        BackingReady.store(true, std::memory_order_release);
+    }
+
+    void ResetForecasts()
+    {
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+        {
+            FrameMemoryForecast& forecast = Forecasts[i];
+            forecast = {};
+
+            // Sin historia se supone un frame lineal
+            for (uint32_t b = 0; b < FRAME_MEMORY_FORECAST_BINS; ++b)
+            {
+                forecast.Shape[b]   = (b + 1.0f) / FRAME_MEMORY_FORECAST_BINS;
+                forecast.Samples[b] = -1.0f;
+            }
+        }
+
+        FrameStart      = Clock::time_point();
+        FrameDurationMs = 0.0f;
+        SampleBin       = -1;
+    }
+
+    static uint32_t ForecastBin(float progress)
+    {
+        const uint32_t bin = (uint32_t)(progress * FRAME_MEMORY_FORECAST_BINS);
+        return (bin < FRAME_MEMORY_FORECAST_BINS) ? bin : FRAME_MEMORY_FORECAST_BINS - 1;
+    }
+
+    static float Predict(const FrameMemoryForecast& forecast, float used, float progress)
+    {
+        progress = (progress < 0.0f) ? 0.0f : (progress > 1.0f ? 1.0f : progress);
+
+        // Shape[b] es la fracción alcanzada al cerrar el tramo b: dentro
+        // del tramo se interpola desde el cierre del anterior
+        const uint32_t bin   = ForecastBin(progress);
+        const float    start = (bin > 0) ? forecast.Shape[bin - 1] : 0.0f;
+        const float    t     = progress * FRAME_MEMORY_FORECAST_BINS - (float)bin;
+        const float    shape = start + (forecast.Shape[bin] - start) * t;
+
+        const float extrapolated = (shape > 0.05f) ? used / shape : forecast.FinalUsage;
+        const float predicted    = progress * extrapolated + (1.0f - progress) * forecast.FinalUsage;
+        return (predicted > used) ? predicted : used;
+    }
+
+    // Muestra del uso en el tramo del último tick, sin leer el reloj.
+    // Sin duración conocida (primer frame, sistemas de worker) no hay
+    // tramo al que asignarla.
+    void RecordSample(FrameMemoryDomain domain)
+    {
+        if (SampleBin < 0)
+            return;
+
+        FrameMemoryForecast& forecast = Forecasts[(uint8_t)domain];
+        const float used = GetUsageRatio(domain);
+        float& sample = forecast.Samples[SampleBin];
+        if (used > sample)
+            sample = used;
+    }
+
+    // Cierra el frame: uso final, forma y error de la previsión.
+    // La previsión de mitad de frame se reconstruye con el último tramo
+    // muestreado de la primera mitad, como la habría dado PredictedUsage
+    // al llegar a 0.5.
+    void UpdateForecasts()
+    {
+        const Clock::time_point now = Clock::now();
+        if (FrameStart != Clock::time_point())
+        {
+            const float duration = (float)std::chrono::duration<double, std::milli>(now - FrameStart).count();
+            FrameDurationMs = (FrameDurationMs > 0.0f)
+                            ? FrameDurationMs + (duration - FrameDurationMs) * FRAME_MEMORY_FORECAST_ALPHA
+                            : duration;
+        }
+        FrameStart = now;
+
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+        {
+            FrameMemoryForecast& forecast = Forecasts[i];
+            if (Budgets[i].MaxBytes == 0)
+                continue;
+
+            const float final = GetUsageRatio((FrameMemoryDomain)i);
+            const float alpha = forecast.HasHistory ? FRAME_MEMORY_FORECAST_ALPHA : 1.0f;
+
+            float midUsed = -1.0f;
+            for (uint32_t b = 0; b < FRAME_MEMORY_FORECAST_BINS / 2; ++b)
+                midUsed = (forecast.Samples[b] > midUsed) ? forecast.Samples[b] : midUsed;
+
+            if (midUsed >= 0.0f)
+            {
+                const float mid   = Predict(forecast, midUsed, 0.5f);
+                const float error = (mid > final) ? mid - final : final - mid;
+                forecast.ErrorEwma += (error - forecast.ErrorEwma) * alpha;
+            }
+
+            forecast.FinalUsage += (final - forecast.FinalUsage) * alpha;
+
+            for (uint32_t b = 0; b < FRAME_MEMORY_FORECAST_BINS; ++b)
+            {
+                if (forecast.Samples[b] >= 0.0f && final > 0.0f)
+                {
+                    const float fraction = (forecast.Samples[b] < final) ? forecast.Samples[b] / final : 1.0f;
+                    forecast.Shape[b] += (fraction - forecast.Shape[b]) * FRAME_MEMORY_FORECAST_ALPHA;
+                }
+                forecast.Samples[b] = -1.0f;
+            }
+
+            forecast.HasHistory = true;
+        }
+    }
+
+    // Invoca evictores en orden de coste hasta que la petición quepa.
+    // Solo en Stack: lo liberado baja lo vivo y el hueco se reutiliza.
+    // En Linear lo consumido no baja dentro del frame y el cursor del
+    // respaldo no retrocede, así que desalojar no admitiría nada.
+    bool Evict(FrameMemoryDomain domain, uint64_t bytes)
+    {
+        const uint8_t d = (uint8_t)domain;
+        FrameMemoryBudget& budget = Budgets[d];
+        if (bytes > budget.MaxBytes || Policies[d] == FrameMemoryPolicy::Linear)
+            return false;
+
+        const uint32_t calls = (EvictorCounts[d] < MaxEvictionCalls) ? EvictorCounts[d] : MaxEvictionCalls;
+
+        for (uint32_t i = 0; i < calls; ++i)
+        {
+            const uint64_t admitted = GetAdmittedBytes(domain);
+            if (admitted + bytes <= budget.MaxBytes)
+                return true;
+
+            const FrameMemoryEvictor& evictor = Evictors[d][i];
+            uint64_t freed = evictor.Evict(evictor.UserData, domain, admitted + bytes - budget.MaxBytes);
+
+            freed = (freed < budget.LiveBytes) ? freed : budget.LiveBytes;
+            budget.LiveBytes -= freed;
+            EvictedBytes[d]  += freed;
+        }
+
+        return GetAdmittedBytes(domain) + bytes <= budget.MaxBytes;
+    }
+
+    // Gestión de páginas comprometidas (solo en BeginFrame, nunca en Request)
+    // El máximo es por ventana de DecommitQuietFrames frames y se reinicia
+    // en cada frontera: un pico aislado solo retiene sus páginas una ventana.
+    void UpdateCommit(uint8_t i)
+    {
+        FrameMemoryArena& arena = Arenas[i];
+        if (!arena.Base)
+            return;
+
+        // Lo más lejos que llegó el frame, no donde quedó el cursor: en
+        // Stack, Free y Rollback lo retroceden sobre páginas ya escritas
+        const uint64_t used = arena.FramePeak;
+
+        // Crecimiento: el frame ya tocó (y falló) esas páginas
+        if (used > arena.Committed)
+            Recommit(arena, AlignUp(used, BackingPageSize));
+
+        if (used > arena.WindowPeak)
+            arena.WindowPeak = used;
+
+        if (++arena.WindowFrames < Backing.DecommitQuietFrames)
+            return;
+
+        const uint64_t target = AlignUp(arena.WindowPeak, BackingPageSize);
+        if (target < arena.Committed)
+            Decommit(arena, target);
+
+        arena.WindowPeak   = 0;
+        arena.WindowFrames = 0;
+    }
+
+    void Decommit(FrameMemoryArena& arena, uint64_t target)
+    {
+#if defined(__linux__)
+        uint8_t* begin = arena.Base + target;
+        const uint64_t bytes = arena.Committed - target;
+
+        // Las páginas bloqueadas no se pueden devolver
+        if (Stats.Locked)
+            munlock(begin, bytes);
+
+#if defined(MADV_FREE)
+        const int advice = Backing.DecommitLazyFree ? MADV_FREE : MADV_DONTNEED;
+#else
+        const int advice = MADV_DONTNEED;
+#endif
+        if (madvise(begin, bytes, advice) != 0)
+            return;
+#endif
+        arena.Committed = target;
+    }
+
+    // Recommit perezoso: no se puebla nada en el hilo principal. Lo que el
+    // frame tocó ya está residente y lo demás falla en su primer acceso.
+    // Con mlock activo se vuelve a bloquear lo ya residente (sin fallos).
+    void Recommit(FrameMemoryArena& arena, uint64_t target)
+    {
+#if defined(__linux__)
+        if (Stats.Locked)
+            mlock(arena.Base + arena.Committed, target - arena.Committed);
+#endif
+        arena.Committed = target;
+    }
+
+    void ReleaseBacking()
+    {
+        WaitForBacking();
+
+        if (MappedBase)
+        {
+#if defined(__linux__)
+            munmap(MappedBase, MappedBytes);
+#else
+            ::operator delete(MappedBase, std::align_val_t(FRAME_MEMORY_PAGE_SIZE));
+#endif
+        }
+
+        MappedBase      = nullptr;
+        MappedBytes     = 0;
+        Backing         = FrameMemoryBackingDesc();
+        BackingPageSize = FRAME_MEMORY_PAGE_SIZE;
+        std::memset(Arenas, 0, sizeof(Arenas));
+        std::memset(&Stats, 0, sizeof(Stats));
+        BackingReady.store(false, std::memory_order_release);
+    }
+
     FrameMemoryBudget Budgets[(uint8_t)FrameMemoryDomain::Count];
+    FrameMemoryPolicy Policies[(uint8_t)FrameMemoryDomain::Count];
     uint64_t TotalBudget;
+
+    // Expulsión
+    FrameMemoryEvictor Evictors[(uint8_t)FrameMemoryDomain::Count][FRAME_MEMORY_MAX_EVICTORS];
+    uint32_t           EvictorCounts[(uint8_t)FrameMemoryDomain::Count];
+    uint64_t           EvictedBytes[(uint8_t)FrameMemoryDomain::Count];
+    uint32_t           MaxEvictionCalls = 4;
+
+    // Previsión
+    FrameMemoryForecast Forecasts[(uint8_t)FrameMemoryDomain::Count];
+    Clock::time_point   FrameStart;
+    float               FrameDurationMs  = 0.0f;
+    float               ProgressOverride = -1.0f;
+    int32_t             SampleBin        = -1;     // tramo de RecordSample (-1: ninguno)
+
+    // Respaldo
+    FrameMemoryArena        Arenas[(uint8_t)FrameMemoryDomain::Count] = {};
+    FrameMemoryBackingStats Stats = {};
+    FrameMemoryBackingDesc  Backing;
+    uint64_t                BackingPageSize = FRAME_MEMORY_PAGE_SIZE;
+    void*                   MappedBase  = nullptr;
+    uint64_t                MappedBytes = 0;
+    std::thread             PreFaultThread;
+    std::atomic<bool>       BackingReady { false };
 };
+
+// Scope especulativo: deshace sus peticiones al salir salvo Commit.
+// Se anida de forma natural; un Commit interno queda a merced del externo.
+class FrameMemoryScope
+{
+public:
+    explicit FrameMemoryScope(FrameMemoryBudgetSystem& system)
+        : System(system), Mark(system.GetMark()), Open(true)
+    {
+    }
+
+    ~FrameMemoryScope()
+    {
+        Rollback();
+    }
+
+    FrameMemoryScope(const FrameMemoryScope&) = delete;
+    FrameMemoryScope& operator=(const FrameMemoryScope&) = delete;
+
+    void Commit()
+    {
+        Open = false;
+    }
+
+    void Rollback()
+    {
+        if (Open)
+            System.Rollback(Mark);
+        Open = false;
+    }
+
+private:
+    FrameMemoryBudgetSystem& System;
+    FrameMemoryMark          Mark;
+    bool                     Open;
+};
+
+// Benchmark del respaldo: arranque (reserva + pre-fault) y coste de
+// tocar todo el presupuesto en el primer frame, con y sin pre-fault.
+struct FrameMemoryBackingBenchmarkResult
+{
+    FrameMemoryBackingStats Stats;      // arranque con el respaldo pedido
+    double   FirstFrameTouchMs;         // primer frame tocando cada página
+    uint64_t FirstFrameFaults;          // fallos menores en ese frame
+    double   ColdTouchMs;               // mismo frame sin pre-fault ni mlock
+    uint64_t ColdFaults;
+};
+
+inline FrameMemoryBackingBenchmarkResult RunFrameMemoryBackingBenchmark(uint64_t totalFrameBudget,
+                                                                        const FrameMemoryBackingDesc& desc)
+{
+    // Pide todo lo que cabe en cada dominio y escribe una vez por página
+    auto touchFrame = [](FrameMemoryBudgetSystem& system, double& ms, uint64_t& faults)
+    {
+        system.BeginFrame();
+
+#if defined(__linux__)
+        rusage before = {};
+        getrusage(RUSAGE_THREAD, &before);
+#endif
+        const auto start = std::chrono::steady_clock::now();
+
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+        {
+            const FrameMemoryDomain domain = (FrameMemoryDomain)i;
+            const uint64_t bytes = system.GetRemaining(domain);
+            uint8_t* block = static_cast<uint8_t*>(system.Allocate(domain, bytes));
+            if (!block)
+                continue;
+            for (uint64_t offset = 0; offset < bytes; offset += FRAME_MEMORY_PAGE_SIZE)
+                block[offset] = 1;
+        }
+
+        ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        faults = 0;
+#if defined(__linux__)
+        rusage after = {};
+        getrusage(RUSAGE_THREAD, &after);
+        faults = (uint64_t)(after.ru_minflt - before.ru_minflt);
+#endif
+    };
+
+    FrameMemoryBackingBenchmarkResult result = {};
+
+    {
+        FrameMemoryBudgetSystem system;
+        system.Initialize(totalFrameBudget, desc);
+        result.Stats = system.GetBackingStats();
+        touchFrame(system, result.FirstFrameTouchMs, result.FirstFrameFaults);
+    }
+
+    {
+        FrameMemoryBackingDesc cold = desc;
+        cold.PreFault = false;
+        cold.Lock     = false;
+
+        FrameMemoryBudgetSystem system;
+        system.Initialize(totalFrameBudget, cold);
+        system.WaitForBacking();
+        touchFrame(system, result.ColdTouchMs, result.ColdFaults);
+    }
+
+    return result;
+}
+
+
+// Repetición de una traza de uso para medir la previsión a mitad de frame
+// frente a la extrapolación lineal ingenua (uso / progreso).
+// usage[f * samplesPerFrame + s] = ratio de uso acumulado del dominio al
+// final del tramo s del frame f (0..1).
+struct FrameMemoryForecastReplayResult
+{
+    float ForecastError;    // error absoluto medio de PredictedUsage a 0.5
+    float NaiveError;       // error absoluto medio de uso / 0.5
+    float TrackedError;     // GetForecastError al terminar (EWMA interno)
+    uint32_t ScoredFrames;  // el primer frame no puntúa: no hay historia
+};
+
+inline FrameMemoryForecastReplayResult RunFrameMemoryForecastReplay(const float* usage, uint32_t frames,
+                                                                    uint32_t samplesPerFrame,
+                                                                    FrameMemoryDomain domain)
+{
+    FrameMemoryForecastReplayResult result = {};
+
+    FrameMemoryBudgetSystem system;
+    system.Initialize(1ull << 40);
+
+    double forecastSum = 0.0;
+    double naiveSum    = 0.0;
+
+    for (uint32_t f = 0; f < frames; ++f)
+    {
+        system.SetFrameProgress(-1.0f);
+        system.BeginFrame();
+        const uint64_t maxBytes = system.GetRemaining(domain);
+
+        float forecast = -1.0f;
+        float naive    = -1.0f;
+        for (uint32_t s = 0; s < samplesPerFrame; ++s)
+        {
+            system.SetFrameProgress((s + 0.5f) / samplesPerFrame);
+
+            const uint64_t target   = (uint64_t)((double)usage[f * samplesPerFrame + s] * (double)maxBytes);
+            const uint64_t admitted = system.GetAdmittedBytes(domain);
+            if (target > admitted)
+                system.Request(domain, target - admitted);
+
+            // Previsión tal como la vería quien consulta al llegar a 0.5
+            if (forecast < 0.0f && (s + 1) * 2 >= samplesPerFrame)
+            {
+                forecast = system.PredictedUsage(domain, 0.5f);
+                naive    = system.GetUsageRatio(domain) * 2.0f;
+            }
+        }
+
+        if (f == 0 || forecast < 0.0f)
+            continue;
+
+        const float final = system.GetUsageRatio(domain);
+        forecastSum += (forecast > final) ? forecast - final : final - forecast;
+        naiveSum    += (naive > final) ? naive - final : final - naive;
+        ++result.ScoredFrames;
+    }
+
+    system.SetFrameProgress(-1.0f);
+    system.BeginFrame();
+
+    if (result.ScoredFrames > 0)
+    {
+        result.ForecastError = (float)(forecastSum / result.ScoredFrames);
+        result.NaiveError    = (float)(naiveSum / result.ScoredFrames);
+    }
+    result.TrackedError = system.GetForecastError(domain);
+    return result;
+}
+
+// Ejemplo de uso
+// FrameMemoryScope scope(MemorySystem);
+// if (TryHigherLOD(MemorySystem))
+//     scope.Commit();
+//
+// if (MemorySystem.IsDomainPredictedCritical(FrameMemoryDomain::Particles))
+//     Particles.ReduceEmission();
 }
@@ -0,0 +1,189 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Hierarchical Error Requests
+
+// Objetivo:
+// Pedir error a ErrorBudgetSystem por cluster / nodo de BVH en lugar
+// de por objeto, bajando a los hijos solo cuando el nodo no cabe
+// o su error es demasiado grueso para concederlo de una vez.
+
+// Filosofía:
+// - Un millón de peticiones cuesta más que el error que deciden
+// - El volumen acota el error de todo lo que contiene
+// - Se baja en la jerarquía solo donde hace falta precisión
+// - El límite de cada ErrorType se respeta igual que con peticiones sueltas
+
+#pragma once
+
+#include "TXErrorBudget.cpp"
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+namespace TX
+{
+
+// Nodo de la jerarquía. Los objetos del subárbol son contiguos
+// (BVH con primitivas reordenadas): [FirstObject, FirstObject + ObjectCount).
+struct ErrorClusterNode
+{
+    float    ErrorSum;     // error de conceder todo el subárbol (puede ser conservador)
+    float    ErrorBound;   // peor error de un objeto del subárbol
+    float    ErrorMin;     // menor error de un objeto del subárbol (poda; 0 = sin poda)
+    uint32_t FirstChild;   // hijos contiguos
+    uint32_t ChildCount;   // 0 = hoja
+    uint32_t FirstObject;
+    uint32_t ObjectCount;
+};
+
+// Rango de objetos concedidos
+struct ErrorObjectRange
+{
+    uint32_t FirstObject;
+    uint32_t ObjectCount;
+};
+
+class HierarchicalErrorRequest
+{
+public:
+    // Error máximo por objeto que se concede en bloque; por encima se baja
+    void SetCoarseness(float maxBound) { Coarseness = maxBound; }
+
+    // Recorre desde root y concede lo que cabe. objectErrors solo se lee
+    // en las hojas a las que se llega (puede ser nulo si nunca se baja a ellas).
+    // Devuelve los objetos concedidos; los rangos quedan en GetGranted().
+    uint32_t Request(ErrorBudgetSystem& budget, ErrorType type,
+                     const ErrorClusterNode* nodes, uint32_t root, const float* objectErrors)
+    {
+        Granted.clear();
+        Requests       = 0;
+        VisitedNodes   = 0;
+        GrantedObjects = 0;
+
+        Stack.clear();
+        Stack.push_back(root);
+
+        while (!Stack.empty())
+        {
+            const ErrorClusterNode& node = nodes[Stack.back()];
+            Stack.pop_back();
+            ++VisitedNodes;
+
+            // Si ni el objeto más barato cabe, el subárbol entero se deniega
+            if (node.ObjectCount == 0 || node.ErrorMin > budget.GetRemaining(type))
+                continue;
+
+            // Todo el nodo de una vez si no es demasiado grueso y cabe
+            if (node.ErrorBound <= Coarseness)
+            {
+                ++Requests;
+                if (budget.Request(type, node.ErrorSum))
+                {
+                    Grant(node.FirstObject, node.ObjectCount);
+                    continue;
+                }
+            }
+
+            if (node.ChildCount > 0)
+            {
+                // Al revés para visitar los hijos en orden (determinista)
+                for (uint32_t c = node.ChildCount; c-- > 0; )
+                    Stack.push_back(node.FirstChild + c);
+                continue;
+            }
+
+            if (!objectErrors)
+                continue;
+
+            // Hoja: objeto a objeto
+            for (uint32_t i = 0; i < node.ObjectCount; ++i)
+            {
+                const uint32_t object = node.FirstObject + i;
+                ++Requests;
+                if (budget.Request(type, objectErrors[object]))
+                    Grant(object, 1);
+            }
+        }
+
+        return GrantedObjects;
+    }
+
+    // Recalcula ErrorSum, ErrorBound y ErrorMin exactos desde el error por objeto.
+    // Requiere que los hijos estén después de su padre en el array.
+    static void Refit(ErrorClusterNode* nodes, uint32_t nodeCount, const float* objectErrors)
+    {
+        for (uint32_t n = nodeCount; n-- > 0; )
+        {
+            ErrorClusterNode& node = nodes[n];
+            float sum   = 0.0f;
+            float bound = 0.0f;
+            float least = INFINITY;
+
+            if (node.ChildCount > 0)
+            {
+                for (uint32_t c = 0; c < node.ChildCount; ++c)
+                {
+                    const ErrorClusterNode& child = nodes[node.FirstChild + c];
+                    sum  += child.ErrorSum;
+                    bound = std::max(bound, child.ErrorBound);
+                    least = std::min(least, child.ErrorMin);
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < node.ObjectCount; ++i)
+                {
+                    const float error = objectErrors[node.FirstObject + i];
+                    sum  += error;
+                    bound = std::max(bound, error);
+                    least = std::min(least, error);
+                }
+            }
+
+            node.ErrorSum   = sum;
+            node.ErrorBound = bound;
+            node.ErrorMin   = (node.ObjectCount > 0) ? least : 0.0f;
+        }
+    }
+
+    // Resultado y telemetría
+    const std::vector<ErrorObjectRange>& GetGranted() const { return Granted; }
+    uint32_t GetGrantedObjects() const { return GrantedObjects; }
+    uint32_t GetRequestCount() const   { return Requests; }
+    uint32_t GetVisitedNodes() const   { return VisitedNodes; }
+
+private:
+    // Rangos contiguos se fusionan
+    void Grant(uint32_t first, uint32_t count)
+    {
+        GrantedObjects += count;
+
+        if (!Granted.empty())
+        {
+            ErrorObjectRange& last = Granted.back();
+            if (last.FirstObject + last.ObjectCount == first)
+            {
+                last.ObjectCount += count;
+                return;
+            }
+        }
+
+        Granted.push_back({ first, count });
+    }
+
+    std::vector<uint32_t>         Stack;
+    std::vector<ErrorObjectRange> Granted;
+
+    float    Coarseness     = 0.05f;
+    uint32_t Requests       = 0;
+    uint32_t VisitedNodes   = 0;
+    uint32_t GrantedObjects = 0;
+};
+
+
+// Ejemplo de uso
+// HierarchicalErrorRequest::Refit(bvhNodes, nodeCount, lodErrors);
+// Hierarchical.Request(ErrorSystem, ErrorType::Spatial, bvhNodes, 0, lodErrors);
+// for (const ErrorObjectRange& range : Hierarchical.GetGranted()) ApplyLOD(range);
+}
@@ -0,0 +1,278 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Lifetime Memory Tiers
+
+// Objetivo:
+// Extender el presupuesto por frame a otras vidas de memoria:
+// varios frames, celda de streaming y nivel. Cada vida tiene su
+// presupuesto y su arena, y se libera entera cuando termina.
+
+// Filosofía:
+// - La fragmentación nace de mezclar vidas distintas en el mismo heap
+// - Cada vida tiene su propia arena y muere de golpe
+// - Mismos dominios y mismas consultas que el presupuesto por frame
+// - Nada se libera suelto: se termina la vida
+
+#pragma once
+
+#include "TXFrameMemoryBudget.cpp"
+
+#include <cstdint>
+
+namespace TX
+{
+
+// Vidas de memoria
+enum class MemoryLifetime : uint8_t
+{
+    Frame,        // muere en el siguiente BeginFrame
+    MultiFrame,   // anillo: vive MultiFrameDepth frames
+    Cell,         // vive mientras la celda de streaming esté cargada
+    Level,        // vive hasta que termina el nivel
+    Count
+};
+
+constexpr uint32_t LIFETIME_MAX_MULTI_FRAME = 4;
+constexpr uint32_t LIFETIME_MAX_CELLS       = 16;
+constexpr uint32_t LIFETIME_INVALID_SLOT    = 0xFFFFFFFFu;
+
+struct LifetimeMemoryDesc
+{
+    uint64_t TotalBytes[(uint8_t)MemoryLifetime::Count] = {};
+    uint32_t MultiFrameDepth = 3;       // frames que vive un bloque MultiFrame
+    uint32_t CellSlots       = 8;       // celdas cargadas a la vez
+    bool     UseBacking      = false;   // arenas reales (mmap) por vida
+    FrameMemoryBackingDesc Backing;
+};
+
+// Presupuesto por vida de memoria.
+// MultiFrame y Cell reparten su total entre sus ranuras; cada ranura
+// es un FrameMemoryBudgetSystem completo que se libera de golpe.
+class LifetimeMemoryBudgetSystem
+{
+public:
+    void Initialize(const LifetimeMemoryDesc& desc)
+    {
+        MultiFrameDepth = Clamp(desc.MultiFrameDepth, 1, LIFETIME_MAX_MULTI_FRAME);
+        CellSlots       = Clamp(desc.CellSlots, 1, LIFETIME_MAX_CELLS);
+        MultiFrameSlot  = 0;
+        CellsInUse      = 0;
+
+        const uint64_t* totals = desc.TotalBytes;
+        InitializeSystem(FrameSystem, totals[(uint8_t)MemoryLifetime::Frame], desc);
+        InitializeSystem(LevelSystem, totals[(uint8_t)MemoryLifetime::Level], desc);
+
+        for (uint32_t i = 0; i < LIFETIME_MAX_MULTI_FRAME; ++i)
+        {
+            const uint64_t share = (i < MultiFrameDepth) ? totals[(uint8_t)MemoryLifetime::MultiFrame] / MultiFrameDepth : 0;
+            InitializeSystem(MultiFrameSystems[i], share, desc);
+        }
+
+        for (uint32_t i = 0; i < LIFETIME_MAX_CELLS; ++i)
+        {
+            const uint64_t share = (i < CellSlots) ? totals[(uint8_t)MemoryLifetime::Cell] / CellSlots : 0;
+            InitializeSystem(CellSystems[i], share, desc);
+        }
+    }
+
+    // Inicio de frame: muere la vida Frame y la ranura MultiFrame más antigua
+    void BeginFrame()
+    {
+        FrameSystem.BeginFrame();
+
+        MultiFrameSlot = (MultiFrameSlot + 1) % MultiFrameDepth;
+        MultiFrameSystems[MultiFrameSlot].BeginFrame();
+    }
+
+    // Celdas de streaming
+    uint32_t AcquireCell()
+    {
+        for (uint32_t i = 0; i < CellSlots; ++i)
+        {
+            const uint32_t bit = 1u << i;
+            if (CellsInUse & bit)
+                continue;
+
+            CellsInUse |= bit;
+            CellSystems[i].Clear();
+            return i;
+        }
+
+        return LIFETIME_INVALID_SLOT;
+    }
+
+    // Termina una vida: toda su memoria se libera de golpe.
+    // slot solo se usa con Cell; Frame y MultiFrame terminan solas.
+    // Es un vaciado, no un cierre de frame: ni previsión ni páginas.
+    void EndLifetime(MemoryLifetime lifetime, uint32_t slot = 0)
+    {
+        switch (lifetime)
+        {
+        case MemoryLifetime::Frame:
+            FrameSystem.Clear();
+            break;
+        case MemoryLifetime::MultiFrame:
+            for (uint32_t i = 0; i < MultiFrameDepth; ++i)
+                MultiFrameSystems[i].Clear();
+            break;
+        case MemoryLifetime::Cell:
+            if (IsCellInUse(slot))
+            {
+                CellsInUse &= ~(1u << slot);
+                CellSystems[slot].Clear();
+            }
+            break;
+        case MemoryLifetime::Level:
+            LevelSystem.Clear();
+            for (uint32_t i = 0; i < CellSlots; ++i)
+                CellSystems[i].Clear();
+            CellsInUse = 0;
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Sistema que respalda una vida (API completa: evictores, marcas, políticas...).
+    // nullptr si la celda está fuera de rango o no está adquirida: su
+    // memoria ya se liberó o pertenece a otra celda.
+    FrameMemoryBudgetSystem* GetSystem(MemoryLifetime lifetime, uint32_t slot = 0)
+    {
+        return const_cast<FrameMemoryBudgetSystem*>(static_cast<const LifetimeMemoryBudgetSystem*>(this)->GetSystem(lifetime, slot));
+    }
+
+    const FrameMemoryBudgetSystem* GetSystem(MemoryLifetime lifetime, uint32_t slot = 0) const
+    {
+        switch (lifetime)
+        {
+        case MemoryLifetime::MultiFrame: return &MultiFrameSystems[MultiFrameSlot];
+        case MemoryLifetime::Cell:       return IsCellInUse(slot) ? &CellSystems[slot] : nullptr;
+        case MemoryLifetime::Level:      return &LevelSystem;
+        default:                         return &FrameSystem;
+        }
+    }
+
+    // Misma API que FrameMemoryBudgetSystem, con la vida delante.
+    // Una celda no adquirida no admite nada y no tiene nada que liberar.
+    bool Request(MemoryLifetime lifetime, FrameMemoryDomain domain, uint64_t bytes, uint32_t slot = 0)
+    {
+        FrameMemoryBudgetSystem* system = GetSystem(lifetime, slot);
+        return system && system->Request(domain, bytes);
+    }
+
+    void Release(MemoryLifetime lifetime, FrameMemoryDomain domain, uint64_t bytes, uint32_t slot = 0)
+    {
+        if (FrameMemoryBudgetSystem* system = GetSystem(lifetime, slot))
+            system->Release(domain, bytes);
+    }
+
+    void* Allocate(MemoryLifetime lifetime, FrameMemoryDomain domain, uint64_t bytes, uint64_t alignment = 16, uint32_t slot = 0)
+    {
+        FrameMemoryBudgetSystem* system = GetSystem(lifetime, slot);
+        return system ? system->Allocate(domain, bytes, alignment) : nullptr;
+    }
+
+    void Free(MemoryLifetime lifetime, FrameMemoryDomain domain, void* ptr, uint64_t bytes, uint32_t slot = 0)
+    {
+        if (FrameMemoryBudgetSystem* system = GetSystem(lifetime, slot))
+            system->Free(domain, ptr, bytes);
+    }
+
+    uint64_t GetRemaining(MemoryLifetime lifetime, FrameMemoryDomain domain, uint32_t slot = 0) const
+    {
+        const FrameMemoryBudgetSystem* system = GetSystem(lifetime, slot);
+        return system ? system->GetRemaining(domain) : 0;
+    }
+
+    uint64_t GetLargestFreeBlock(MemoryLifetime lifetime, FrameMemoryDomain domain, uint32_t slot = 0) const
+    {
+        const FrameMemoryBudgetSystem* system = GetSystem(lifetime, slot);
+        return system ? system->GetLargestFreeBlock(domain) : 0;
+    }
+
+    float GetFragmentation(MemoryLifetime lifetime, FrameMemoryDomain domain, uint32_t slot = 0) const
+    {
+        const FrameMemoryBudgetSystem* system = GetSystem(lifetime, slot);
+        return system ? system->GetFragmentation(domain) : 0.0f;
+    }
+
+    float GetUsageRatio(MemoryLifetime lifetime, FrameMemoryDomain domain, uint32_t slot = 0) const
+    {
+        const FrameMemoryBudgetSystem* system = GetSystem(lifetime, slot);
+        return system ? system->GetUsageRatio(domain) : 0.0f;
+    }
+
+    bool IsDomainCritical(MemoryLifetime lifetime, FrameMemoryDomain domain, uint32_t slot = 0) const
+    {
+        const FrameMemoryBudgetSystem* system = GetSystem(lifetime, slot);
+        return system && system->IsDomainCritical(domain);
+    }
+
+    // Vivo en un dominio sumando todas las ranuras de la vida
+    uint64_t GetLiveBytes(MemoryLifetime lifetime, FrameMemoryDomain domain) const
+    {
+        uint64_t live = 0;
+        switch (lifetime)
+        {
+        case MemoryLifetime::MultiFrame:
+            for (uint32_t i = 0; i < MultiFrameDepth; ++i)
+                live += MultiFrameSystems[i].GetLiveBytes(domain);
+            break;
+        case MemoryLifetime::Cell:
+            for (uint32_t i = 0; i < CellSlots; ++i)
+                live += CellSystems[i].GetLiveBytes(domain);
+            break;
+        default:
+            live = GetSystem(lifetime)->GetLiveBytes(domain);
+            break;
+        }
+        return live;
+    }
+
+    uint32_t GetMultiFrameDepth() const { return MultiFrameDepth; }
+    uint32_t GetCellSlots() const       { return CellSlots; }
+    bool     IsCellInUse(uint32_t slot) const { return slot < CellSlots && (CellsInUse & (1u << slot)); }
+
+    void Reset()
+    {
+        FrameSystem.Reset();
+        LevelSystem.Reset();
+        for (FrameMemoryBudgetSystem& system : MultiFrameSystems)
+            system.Reset();
+        for (FrameMemoryBudgetSystem& system : CellSystems)
+            system.Reset();
+
+        MultiFrameSlot = 0;
+        CellsInUse     = 0;
+    }
+
+private:
+    static uint32_t Clamp(uint32_t value, uint32_t low, uint32_t high)
+    {
+        return value < low ? low : (value > high ? high : value);
+    }
+
+    static void InitializeSystem(FrameMemoryBudgetSystem& system, uint64_t total, const LifetimeMemoryDesc& desc)
+    {
+        if (desc.UseBacking && total > 0)
+            system.Initialize(total, desc.Backing);
+        else
+            system.Initialize(total);
+    }
+
+    FrameMemoryBudgetSystem FrameSystem;
+    FrameMemoryBudgetSystem MultiFrameSystems[LIFETIME_MAX_MULTI_FRAME];
+    FrameMemoryBudgetSystem CellSystems[LIFETIME_MAX_CELLS];
+    FrameMemoryBudgetSystem LevelSystem;
+
+    uint32_t MultiFrameDepth = 1;
+    uint32_t MultiFrameSlot  = 0;
+    uint32_t CellSlots       = 1;
+    uint32_t CellsInUse      = 0;   // bit por ranura de celda
+};
+
+
+// Ejemplo de uso
+// uint32_t cell = Lifetimes.AcquireCell();
+// void* navMesh = Lifetimes.Allocate(MemoryLifetime::Cell, FrameMemoryDomain::AI, bytes, 16, cell);
+// Lifetimes.EndLifetime(MemoryLifetime::Cell, cell);
+}
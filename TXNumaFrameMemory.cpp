@@ -0,0 +1,273 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: NUMA-Aware Frame Memory
+
+// Objetivo:
+// En máquinas de varios sockets, dar a cada nodo NUMA su propio
+// presupuesto y su propia arena por frame, de modo que cada worker
+// consuma memoria local y solo cruce de nodo cuando el suyo se agota.
+
+// Filosofía:
+// - La memoria lejana cuesta tiempo: también es presupuesto
+// - Cada nodo es un FrameMemoryBudgetSystem completo
+// - Pedir prestado a otro nodo es la excepción y se mide
+// - Con un solo nodo todo se comporta como el sistema por frame
+
+#pragma once
+
+#include "TXFrameMemoryBudget.cpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace TX
+{
+
+constexpr uint32_t NUMA_MAX_NODES = 8;
+
+// Un FrameMemoryBudgetSystem por nodo, cada uno con su mutex.
+// El total se reparte a partes iguales entre los nodos.
+class NumaFrameMemoryBudgetSystem
+{
+public:
+    void Initialize(uint64_t totalFrameBudget)
+    {
+        DetectNodes();
+        for (uint32_t n = 0; n < NodeCount; ++n)
+        {
+            std::lock_guard<std::mutex> lock(Nodes[n].Lock);
+            Nodes[n].System.Initialize(totalFrameBudget / NodeCount);
+            std::memset(Nodes[n].BorrowedBytes, 0, sizeof(Nodes[n].BorrowedBytes));
+        }
+    }
+
+    // Con respaldo: la arena de cada nodo se enlaza a su nodo con mbind
+    void Initialize(uint64_t totalFrameBudget, const FrameMemoryBackingDesc& backing)
+    {
+        DetectNodes();
+        for (uint32_t n = 0; n < NodeCount; ++n)
+        {
+            FrameMemoryBackingDesc desc = backing;
+            if (NodeCount > 1)
+                desc.NumaNode = NodeIds[n];
+
+            std::lock_guard<std::mutex> lock(Nodes[n].Lock);
+            Nodes[n].System.Initialize(totalFrameBudget / NodeCount, desc);
+            std::memset(Nodes[n].BorrowedBytes, 0, sizeof(Nodes[n].BorrowedBytes));
+        }
+    }
+
+    void BeginFrame()
+    {
+        for (uint32_t n = 0; n < NodeCount; ++n)
+        {
+            std::lock_guard<std::mutex> lock(Nodes[n].Lock);
+            Nodes[n].System.BeginFrame();
+            std::memset(Nodes[n].BorrowedBytes, 0, sizeof(Nodes[n].BorrowedBytes));
+        }
+    }
+
+    // Nodo (índice) del hilo que llama
+    uint32_t GetCurrentNode() const
+    {
+#if defined(__linux__) && defined(SYS_getcpu)
+        if (NodeCount > 1)
+        {
+            unsigned cpu = 0, node = 0;
+            if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+            {
+                for (uint32_t n = 0; n < NodeCount; ++n)
+                    if (NodeIds[n] == (int32_t)node)
+                        return n;
+            }
+        }
+#endif
+        return 0;
+    }
+
+    // Solicitud desde el nodo local; grantedNode indica quién la sirvió
+    // (necesario para el Release correspondiente)
+    bool Request(FrameMemoryDomain domain, uint64_t bytes, uint32_t* grantedNode = nullptr)
+    {
+        return RequestOnNode(GetCurrentNode(), domain, bytes, grantedNode);
+    }
+
+    // Para workers fijados que ya conocen su nodo
+    bool RequestOnNode(uint32_t node, FrameMemoryDomain domain, uint64_t bytes, uint32_t* grantedNode = nullptr)
+    {
+        node = (node < NodeCount) ? node : 0;
+
+        for (uint32_t step = 0; step < NodeCount; ++step)
+        {
+            const uint32_t n = (node + step) % NodeCount;
+
+            {
+                std::lock_guard<std::mutex> lock(Nodes[n].Lock);
+                if (!Nodes[n].System.Request(domain, bytes))
+                    continue;
+            }
+
+            if (step > 0)
+                AddBorrowed(node, domain, bytes);
+            if (grantedNode)
+                *grantedNode = n;
+            return true;
+        }
+
+        return false;
+    }
+
+    void Release(uint32_t grantedNode, FrameMemoryDomain domain, uint64_t bytes)
+    {
+        if (grantedNode >= NodeCount)
+            return;
+
+        std::lock_guard<std::mutex> lock(Nodes[grantedNode].Lock);
+        Nodes[grantedNode].System.Release(domain, bytes);
+    }
+
+    // Memoria real del nodo local; otro nodo solo si el local se agota
+    void* Allocate(FrameMemoryDomain domain, uint64_t bytes, uint64_t alignment = 16)
+    {
+        return AllocateOnNode(GetCurrentNode(), domain, bytes, alignment);
+    }
+
+    void* AllocateOnNode(uint32_t node, FrameMemoryDomain domain, uint64_t bytes, uint64_t alignment = 16)
+    {
+        node = (node < NodeCount) ? node : 0;
+
+        for (uint32_t step = 0; step < NodeCount; ++step)
+        {
+            const uint32_t n = (node + step) % NodeCount;
+
+            void* ptr;
+            {
+                std::lock_guard<std::mutex> lock(Nodes[n].Lock);
+                ptr = Nodes[n].System.Allocate(domain, bytes, alignment);
+            }
+            if (!ptr)
+                continue;
+
+            if (step > 0)
+                AddBorrowed(node, domain, bytes);
+            return ptr;
+        }
+
+        return nullptr;
+    }
+
+    // El nodo dueño se deduce de la dirección
+    void Free(FrameMemoryDomain domain, void* ptr, uint64_t bytes)
+    {
+        for (uint32_t n = 0; n < NodeCount; ++n)
+        {
+            std::lock_guard<std::mutex> lock(Nodes[n].Lock);
+            if (!Nodes[n].System.Contains(domain, ptr))
+                continue;
+
+            Nodes[n].System.Free(domain, ptr, bytes);
+            return;
+        }
+    }
+
+    // Consultas
+    uint32_t GetNodeCount() const           { return NodeCount; }
+    int32_t  GetNodeId(uint32_t node) const { return NodeIds[node]; }
+
+    uint64_t GetRemaining(uint32_t node, FrameMemoryDomain domain)
+    {
+        std::lock_guard<std::mutex> lock(Nodes[node].Lock);
+        return Nodes[node].System.GetRemaining(domain);
+    }
+
+    uint64_t GetRemaining(FrameMemoryDomain domain)
+    {
+        uint64_t remaining = 0;
+        for (uint32_t n = 0; n < NodeCount; ++n)
+            remaining += GetRemaining(n, domain);
+        return remaining;
+    }
+
+    // Bytes que este nodo tuvo que pedir prestados en el frame
+    uint64_t GetBorrowedBytes(uint32_t node, FrameMemoryDomain domain)
+    {
+        std::lock_guard<std::mutex> lock(Nodes[node].Lock);
+        return Nodes[node].BorrowedBytes[(uint8_t)domain];
+    }
+
+    // Acceso directo (sin bloqueo: solo desde el hilo principal entre frames)
+    FrameMemoryBudgetSystem& GetNodeSystem(uint32_t node) { return Nodes[node].System; }
+
+    void WaitForBacking()
+    {
+        for (uint32_t n = 0; n < NodeCount; ++n)
+            Nodes[n].System.WaitForBacking();
+    }
+
+private:
+    struct NumaNodeState
+    {
+        FrameMemoryBudgetSystem System;
+        std::mutex              Lock;
+        uint64_t                BorrowedBytes[(uint8_t)FrameMemoryDomain::Count];
+    };
+
+    void AddBorrowed(uint32_t node, FrameMemoryDomain domain, uint64_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(Nodes[node].Lock);
+        Nodes[node].BorrowedBytes[(uint8_t)domain] += bytes;
+    }
+
+    // Nodos en línea según /sys ("0-1", "0,2-3"...); un nodo si no hay NUMA
+    void DetectNodes()
+    {
+        NodeCount  = 0;
+        NodeIds[0] = 0;
+
+#if defined(__linux__)
+        if (std::FILE* file = std::fopen("/sys/devices/system/node/online", "r"))
+        {
+            int first = 0, last = 0;
+            while (NodeCount < NUMA_MAX_NODES && std::fscanf(file, "%d", &first) == 1)
+            {
+                last = first;
+                int c = std::fgetc(file);
+                if (c == '-')
+                {
+                    if (std::fscanf(file, "%d", &last) != 1)
+                        break;
+                    c = std::fgetc(file);
+                }
+
+                for (int id = first; id <= last && NodeCount < NUMA_MAX_NODES; ++id)
+                    NodeIds[NodeCount++] = id;
+
+                if (c != ',')
+                    break;
+            }
+            std::fclose(file);
+        }
+#endif
+
+        if (NodeCount == 0)
+        {
+            NodeIds[0] = 0;
+            NodeCount  = 1;
+        }
+    }
+
+    NumaNodeState Nodes[NUMA_MAX_NODES];
+    int32_t       NodeIds[NUMA_MAX_NODES] = {};
+    uint32_t      NodeCount = 1;
+};
+
+
+// Ejemplo de uso
+// NumaMemory.Initialize(512 * MB, backingDesc);
+// void* scratch = NumaMemory.Allocate(FrameMemoryDomain::Physics, 256 * KB);   // nodo del worker
+}
@@ -0,0 +1,244 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Parallel Budget Decisions
+
+// Objetivo:
+// Ejecutar una decisión por objeto (LOD, shading...) repartida entre
+// los workers del job system, cada uno con su propio acumulador de
+// error y memoria y su parte del presupuesto, y reconciliar al final.
+
+// Filosofía:
+// - Cada worker decide contra su parte: sin locks ni atómicos
+// - El reparto es estático: el resultado no depende del orden de los hilos
+// - Si lo unido no cabe, se repasa en orden de índice y solo se
+//   vuelven a decidir los objetos que ya no caben
+// - El presupuesto global nunca se excede
+
+#pragma once
+
+#include "TXErrorBudget.cpp"
+#include "TXFrameMemoryBudget.cpp"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace TX
+{
+
+struct ParallelBudgetStats
+{
+    uint32_t Decisions;
+    uint32_t Workers;
+    uint32_t Accepted;
+    uint32_t Rerun;        // decisiones repetidas contra el presupuesto global
+    bool     Reconciled;   // lo unido no cabía y se repasó en orden
+};
+
+// Despachador por defecto: un hilo por worker (el 0 en el hilo que llama).
+// Con job system: cualquier callable (workerCount, job) que ejecute
+// job(w) para cada w en [0, workerCount) y espere a que terminen.
+struct ParallelBudgetThreadDispatch
+{
+    template <typename Job>
+    void operator()(uint32_t workerCount, const Job& job) const
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(workerCount - 1);
+        for (uint32_t w = 1; w < workerCount; ++w)
+            threads.emplace_back([&job, w]() { job(w); });
+
+        job(0);
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+};
+
+class ParallelBudgetRunner
+{
+public:
+    // > 1 da a cada worker más que su parte exacta: menos objetos
+    // denegados por mal reparto a cambio de reconciliar más a menudo
+    void SetOvercommit(float overcommit) { Overcommit = overcommit > 0.0f ? overcommit : 1.0f; }
+
+    // decide(index, ErrorBudgetSystem&, FrameMemoryBudgetSystem&) -> bool
+    // Pide error/memoria al sistema que recibe y devuelve si aceptó la
+    // opción cara. Debe ser reentrante entre índices distintos.
+    // Con memory nulo los workers no tienen presupuesto de memoria.
+    template <typename Decide, typename Dispatch = ParallelBudgetThreadDispatch>
+    ParallelBudgetStats Run(uint32_t count, uint32_t workerCount,
+                            ErrorBudgetSystem& error, FrameMemoryBudgetSystem* memory,
+                            const Decide& decide, const Dispatch& dispatch = Dispatch())
+    {
+        workerCount = std::max<uint32_t>(1, std::min(workerCount, std::max<uint32_t>(count, 1)));
+        Reserve(workerCount);
+
+        Accepted.assign(count, 0);
+        Costs.resize(count);
+
+        ParallelBudgetStats stats = {};
+        stats.Decisions = count;
+        stats.Workers   = workerCount;
+
+        for (uint32_t w = 0; w < workerCount; ++w)
+        {
+            error.ForkWorker(w, workerCount, WorkerError[w], Overcommit);
+            if (memory)
+                memory->ForkWorker(w, workerCount, WorkerMemory[w], Overcommit);
+            else
+                WorkerMemory[w].Reset();
+        }
+
+        // Fase paralela: cada worker decide su tramo contra su parte
+        dispatch(workerCount, [&](uint32_t w)
+        {
+            ErrorBudgetSystem&       workerError  = WorkerError[w];
+            FrameMemoryBudgetSystem& workerMemory = WorkerMemory[w];
+
+            const uint32_t begin = (uint32_t)((uint64_t)count * w / workerCount);
+            const uint32_t end   = (uint32_t)((uint64_t)count * (w + 1) / workerCount);
+
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const ErrorBudgetMark errorBefore  = workerError.GetMark();
+                const FrameMemoryMark memoryBefore = workerMemory.GetMark();
+
+                Accepted[i] = decide(i, workerError, workerMemory) ? 1 : 0;
+
+                const ErrorBudgetMark errorAfter  = workerError.GetMark();
+                const FrameMemoryMark memoryAfter = workerMemory.GetMark();
+
+                DecisionCost& cost = Costs[i];
+                for (uint32_t t = 0; t < ERROR_TYPE_COUNT; ++t)
+                    cost.Error[t] = errorAfter.Current[t] - errorBefore.Current[t];
+                for (uint8_t d = 0; d < (uint8_t)FrameMemoryDomain::Count; ++d)
+                    cost.Bytes[d] = memoryAfter.UsedBytes[d] - memoryBefore.UsedBytes[d];
+            }
+        });
+
+        if (Fits(workerCount, error, memory))
+        {
+            for (uint32_t w = 0; w < workerCount; ++w)
+            {
+                error.Join(WorkerError[w]);
+                if (memory)
+                    memory->Join(WorkerMemory[w]);
+            }
+        }
+        else
+        {
+            stats.Reconciled = true;
+            stats.Rerun      = Reconcile(count, error, memory, decide);
+        }
+
+        for (uint8_t accepted : Accepted)
+            stats.Accepted += accepted;
+
+        LastStats = stats;
+        return stats;
+    }
+
+    bool IsAccepted(uint32_t index) const { return Accepted[index] != 0; }
+    const ParallelBudgetStats& GetLastStats() const { return LastStats; }
+
+private:
+    struct DecisionCost
+    {
+        float    Error[ERROR_TYPE_COUNT];
+        uint64_t Bytes[(uint8_t)FrameMemoryDomain::Count];
+    };
+
+    void Reserve(uint32_t workerCount)
+    {
+        if (workerCount <= WorkerCapacity)
+            return;
+
+        WorkerError.resize(workerCount);
+        WorkerMemory.reset(new FrameMemoryBudgetSystem[workerCount]);
+        WorkerCapacity = workerCount;
+    }
+
+    // Suma en orden de worker (mismo redondeo en cada ejecución)
+    bool Fits(uint32_t workerCount, const ErrorBudgetSystem& error, const FrameMemoryBudgetSystem* memory) const
+    {
+        for (uint32_t t = 0; t < ERROR_TYPE_COUNT; ++t)
+        {
+            float total = 0.0f;
+            for (uint32_t w = 0; w < workerCount; ++w)
+                total += WorkerError[w].GetMark().Current[t];
+            if (total > error.GetRemaining((ErrorType)t))
+                return false;
+        }
+
+        if (!memory)
+            return true;
+
+        for (uint8_t d = 0; d < (uint8_t)FrameMemoryDomain::Count; ++d)
+        {
+            uint64_t total = 0;
+            for (uint32_t w = 0; w < workerCount; ++w)
+                total += WorkerMemory[w].GetMark().UsedBytes[d];
+            if (total > memory->GetRemaining((FrameMemoryDomain)d))
+                return false;
+        }
+
+        return true;
+    }
+
+    // Repaso en orden de índice contra el global: se cobra lo ya decidido
+    // y solo se repite la decisión de lo que deja de caber
+    template <typename Decide>
+    uint32_t Reconcile(uint32_t count, ErrorBudgetSystem& error, FrameMemoryBudgetSystem* memory, const Decide& decide)
+    {
+        FrameMemoryBudgetSystem& decisionMemory = memory ? *memory : WorkerMemory[0];
+        if (!memory)
+            decisionMemory.Reset();
+
+        uint32_t rerun = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const DecisionCost& cost = Costs[i];
+            const ErrorBudgetMark errorMark  = error.GetMark();
+            const FrameMemoryMark memoryMark = decisionMemory.GetMark();
+
+            bool fits = true;
+            for (uint32_t t = 0; t < ERROR_TYPE_COUNT && fits; ++t)
+                fits = cost.Error[t] <= 0.0f || error.Request((ErrorType)t, cost.Error[t]);
+            for (uint8_t d = 0; d < (uint8_t)FrameMemoryDomain::Count && fits; ++d)
+                fits = cost.Bytes[d] == 0 || decisionMemory.Request((FrameMemoryDomain)d, cost.Bytes[d]);
+
+            if (fits)
+                continue;
+
+            error.Rollback(errorMark);
+            decisionMemory.Rollback(memoryMark);
+
+            Accepted[i] = decide(i, error, decisionMemory) ? 1 : 0;
+            ++rerun;
+        }
+
+        return rerun;
+    }
+
+    std::vector<ErrorBudgetSystem>             WorkerError;
+    std::unique_ptr<FrameMemoryBudgetSystem[]> WorkerMemory;
+    uint32_t                                   WorkerCapacity = 0;
+
+    std::vector<uint8_t>      Accepted;
+    std::vector<DecisionCost> Costs;
+
+    float               Overcommit = 1.0f;
+    ParallelBudgetStats LastStats  = {};
+};
+
+
+// Ejemplo de uso
+// Runner.Run(objectCount, workerCount, ErrorSystem, &MemorySystem,
+//     [&](uint32_t i, ErrorBudgetSystem& error, FrameMemoryBudgetSystem& memory)
+//     {
+//         return memory.Request(FrameMemoryDomain::Geometry, highLodBytes[i]) ||
+//                !error.Request(ErrorType::Spatial, lodError[i]);
+//     },
+//     [&](uint32_t count, const auto& job) { Jobs.ParallelFor(count, job); });
+}
@@ -0,0 +1,373 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Relocatable Heap
+
+// Objetivo:
+// Dar a las vidas largas (celda, nivel) asignaciones por handle
+// que se pueden mover, y un compactador incremental que cierra
+// huecos moviendo un número acotado de bytes por frame.
+
+// Filosofía:
+// - Un puntero crudo no se puede mover; un handle sí
+// - Compactar es trabajo del frame y tiene presupuesto como todo lo demás
+// - Lo fijado (pinned) no se mueve: hace de barrera
+// - La fragmentación se mide, no se intuye
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace TX
+{
+
+constexpr uint32_t RELOCATABLE_INVALID_INDEX = 0xFFFFFFFFu;
+
+struct RelocatableHandle
+{
+    uint32_t Index      = RELOCATABLE_INVALID_INDEX;
+    uint32_t Generation = 0;
+
+    bool IsValid() const { return Index != RELOCATABLE_INVALID_INDEX; }
+};
+
+// Aviso de movimiento (para quien guarde direcciones fuera del heap, p. ej. la GPU)
+using RelocatableMoveFn = void(*)(void* userData, RelocatableHandle handle, void* from, void* to);
+
+struct RelocatableCompactionStats
+{
+    uint64_t MovedBytes;
+    uint32_t MovedBlocks;
+    double   ElapsedMs;
+    bool     Finished;     // no quedan huecos que cerrar
+};
+
+// Heap con handles sobre un bloque contiguo (normalmente de una vida larga:
+// Lifetimes.Allocate(MemoryLifetime::Level, FrameMemoryDomain::Geometry, ...)).
+// Con base nula solo lleva la contabilidad y no copia memoria.
+class RelocatableHeap
+{
+public:
+    void Initialize(void* base, uint64_t capacity)
+    {
+        Base         = static_cast<uint8_t*>(base);
+        Capacity     = capacity;
+        UsedBytes    = 0;
+        PackedCursor = 0;
+        Blocks.clear();
+        Order.clear();
+        FreeIndices.clear();
+        GapsByOffset.clear();
+        GapsBySize.clear();
+        AddGap(0, capacity);
+    }
+
+    void SetMoveCallback(RelocatableMoveFn callback, void* userData)
+    {
+        MoveCallback = callback;
+        MoveUserData = userData;
+    }
+
+    // Mejor hueco (el menor que quepa) según el árbol de huecos por tamaño;
+    // handle inválido si no hay hueco contiguo
+    RelocatableHandle Allocate(uint64_t bytes, uint32_t alignment = 16)
+    {
+        RelocatableHandle handle;
+        if (bytes == 0)
+            return handle;
+
+        alignment = alignment ? alignment : 1;
+
+        uint64_t offset = 0;
+        bool     found  = false;
+
+        // El alineamiento puede descartar algún hueco justo; casi siempre vale el primero
+        for (auto it = GapsBySize.lower_bound({ bytes, 0 }); it != GapsBySize.end(); ++it)
+        {
+            const uint64_t start = AlignUp(it->second, alignment);
+            if (start + bytes <= it->second + it->first)
+            {
+                offset = start;
+                found  = true;
+                break;
+            }
+        }
+
+        if (!found)
+            return handle;
+
+        uint32_t index;
+        if (!FreeIndices.empty())
+        {
+            index = FreeIndices.back();
+            FreeIndices.pop_back();
+        }
+        else
+        {
+            index = (uint32_t)Blocks.size();
+            Blocks.push_back({});
+        }
+
+        RelocatableBlock& block = Blocks[index];
+        block.Offset    = offset;
+        block.Bytes     = bytes;
+        block.Alignment = alignment;
+        block.PinCount  = 0;
+        block.Live      = true;
+
+        const uint32_t position = FindPosition(offset);
+        Order.insert(Order.begin() + position, index);
+        PackedCursor = std::min(PackedCursor, position);
+        UsedBytes   += bytes;
+        ClaimRange(offset, offset + bytes);
+
+        handle.Index      = index;
+        handle.Generation = block.Generation;
+        return handle;
+    }
+
+    void Free(RelocatableHandle handle)
+    {
+        if (!IsAlive(handle))
+            return;
+
+        RelocatableBlock& block = Blocks[handle.Index];
+        const uint32_t position = FindPosition(block.Offset);
+
+        Order.erase(Order.begin() + position);
+        PackedCursor = std::min(PackedCursor, position);
+        UsedBytes   -= block.Bytes;
+        ReleaseRange(block.Offset, block.Offset + block.Bytes);
+
+        block.Live = false;
+        ++block.Generation;
+        FreeIndices.push_back(handle.Index);
+    }
+
+    // Dirección actual; puede cambiar tras Compact salvo que esté fijado
+    void* Resolve(RelocatableHandle handle) const
+    {
+        if (!IsAlive(handle) || !Base)
+            return nullptr;
+        return Base + Blocks[handle.Index].Offset;
+    }
+
+    uint64_t GetOffset(RelocatableHandle handle) const
+    {
+        return IsAlive(handle) ? Blocks[handle.Index].Offset : 0;
+    }
+
+    bool IsAlive(RelocatableHandle handle) const
+    {
+        return handle.Index < Blocks.size() &&
+               Blocks[handle.Index].Live &&
+               Blocks[handle.Index].Generation == handle.Generation;
+    }
+
+    // Fijado: el compactador no lo mueve mientras PinCount > 0
+    void Pin(RelocatableHandle handle)
+    {
+        if (IsAlive(handle))
+            ++Blocks[handle.Index].PinCount;
+    }
+
+    void Unpin(RelocatableHandle handle)
+    {
+        if (!IsAlive(handle) || Blocks[handle.Index].PinCount == 0)
+            return;
+
+        // Al soltarlo, el hueco que protegía vuelve a ser compactable
+        RelocatableBlock& block = Blocks[handle.Index];
+        if (--block.PinCount == 0)
+            PackedCursor = std::min(PackedCursor, FindPosition(block.Offset));
+    }
+
+    // Compactación incremental: desliza bloques hacia abajo hasta agotar
+    // maxBytes o maxMs. Siempre mueve al menos un bloque por llamada para
+    // avanzar aunque sea mayor que maxBytes.
+    RelocatableCompactionStats Compact(uint64_t maxBytes, double maxMs)
+    {
+        const Clock::time_point start = Clock::now();
+        RelocatableCompactionStats stats = {};
+
+        uint64_t prevEnd = 0;
+        if (PackedCursor > 0)
+        {
+            const RelocatableBlock& last = Blocks[Order[PackedCursor - 1]];
+            prevEnd = last.Offset + last.Bytes;
+        }
+
+        uint32_t k = PackedCursor;
+        for (; k < (uint32_t)Order.size(); ++k)
+        {
+            const uint32_t index = Order[k];
+            RelocatableBlock& block = Blocks[index];
+            const uint64_t target = AlignUp(prevEnd, block.Alignment);
+
+            if (block.PinCount == 0 && target < block.Offset)
+            {
+                if (stats.MovedBlocks > 0 &&
+                    (stats.MovedBytes + block.Bytes > maxBytes || ElapsedMs(start) >= maxMs))
+                    break;
+
+                Move(index, target);
+                stats.MovedBytes += block.Bytes;
+                ++stats.MovedBlocks;
+            }
+
+            prevEnd = block.Offset + block.Bytes;
+        }
+
+        PackedCursor    = k;
+        stats.Finished  = k == (uint32_t)Order.size();
+        stats.ElapsedMs = ElapsedMs(start);
+        LastCompaction  = stats;
+        return stats;
+    }
+
+    // Métricas de fragmentación
+    uint64_t GetCapacity() const  { return Capacity; }
+    uint64_t GetUsedBytes() const { return UsedBytes; }
+    uint64_t GetFreeBytes() const { return Capacity - UsedBytes; }
+
+    // Mayor bloque contiguo libre: el último del árbol por tamaño, O(1)
+    uint64_t GetLargestFreeBlock() const
+    {
+        return GapsBySize.empty() ? 0 : GapsBySize.rbegin()->first;
+    }
+
+    uint32_t GetFreeBlockCount() const { return (uint32_t)GapsByOffset.size(); }
+
+    // 0 = todo lo libre es contiguo, 1 = libre pulverizado
+    float GetFragmentation() const
+    {
+        const uint64_t free = GetFreeBytes();
+        return free ? 1.0f - (float)GetLargestFreeBlock() / (float)free : 0.0f;
+    }
+
+    const RelocatableCompactionStats& GetLastCompaction() const { return LastCompaction; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct RelocatableBlock
+    {
+        uint64_t Offset;
+        uint64_t Bytes;
+        uint32_t Alignment;
+        uint32_t Generation;
+        uint16_t PinCount;
+        bool     Live;
+    };
+
+    static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    static double ElapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    uint32_t FindPosition(uint64_t offset) const
+    {
+        auto it = std::lower_bound(Order.begin(), Order.end(), offset,
+            [this](uint32_t index, uint64_t value) { return Blocks[index].Offset < value; });
+        return (uint32_t)(it - Order.begin());
+    }
+
+    void Move(uint32_t index, uint64_t target)
+    {
+        RelocatableBlock& block = Blocks[index];
+
+        // Hacia abajo: memmove tolera el solape
+        void* from = Base ? Base + block.Offset : nullptr;
+        void* to   = Base ? Base + target : nullptr;
+        if (Base)
+            std::memmove(to, from, block.Bytes);
+
+        ReleaseRange(block.Offset, block.Offset + block.Bytes);
+        ClaimRange(target, target + block.Bytes);
+        block.Offset = target;
+
+        if (MoveCallback)
+            MoveCallback(MoveUserData, { index, block.Generation }, from, to);
+    }
+
+    // Huecos libres máximos, mantenidos en cada Allocate, Free y Move
+    void AddGap(uint64_t begin, uint64_t end)
+    {
+        if (end <= begin)
+            return;
+        GapsByOffset[begin] = end;
+        GapsBySize.insert({ end - begin, begin });
+    }
+
+    void RemoveGap(std::map<uint64_t, uint64_t>::iterator gap)
+    {
+        GapsBySize.erase({ gap->second - gap->first, gap->first });
+        GapsByOffset.erase(gap);
+    }
+
+    // Ocupa [begin, end) dentro del hueco que lo contiene
+    void ClaimRange(uint64_t begin, uint64_t end)
+    {
+        auto gap = std::prev(GapsByOffset.upper_bound(begin));
+        const uint64_t gapBegin = gap->first;
+        const uint64_t gapEnd   = gap->second;
+
+        RemoveGap(gap);
+        AddGap(gapBegin, begin);
+        AddGap(end, gapEnd);
+    }
+
+    // Libera [begin, end) fusionando con los huecos vecinos
+    void ReleaseRange(uint64_t begin, uint64_t end)
+    {
+        auto next = GapsByOffset.find(end);
+        if (next != GapsByOffset.end())
+        {
+            end = next->second;
+            RemoveGap(next);
+        }
+
+        auto prev = GapsByOffset.lower_bound(begin);
+        if (prev != GapsByOffset.begin() && (--prev)->second == begin)
+        {
+            begin = prev->first;
+            RemoveGap(prev);
+        }
+
+        AddGap(begin, end);
+    }
+
+    std::vector<RelocatableBlock> Blocks;        // por índice de handle
+    std::vector<uint32_t>         Order;         // vivos ordenados por offset
+    std::vector<uint32_t>         FreeIndices;
+
+    std::map<uint64_t, uint64_t>            GapsByOffset;   // inicio -> fin
+    std::set<std::pair<uint64_t, uint64_t>> GapsBySize;     // (tamaño, inicio)
+
+    uint8_t* Base         = nullptr;
+    uint64_t Capacity     = 0;
+    uint64_t UsedBytes    = 0;
+    uint32_t PackedCursor = 0;   // Order[0, PackedCursor) ya está compactado
+
+    RelocatableMoveFn MoveCallback = nullptr;
+    void*             MoveUserData = nullptr;
+
+    RelocatableCompactionStats LastCompaction = {};
+};
+
+
+// Ejemplo de uso
+// Heap.Initialize(Lifetimes.Allocate(MemoryLifetime::Level, FrameMemoryDomain::Geometry, size), size);
+// RelocatableHandle mesh = Heap.Allocate(meshBytes);
+// Heap.Compact(256 * 1024, 0.25);
+// Mesh* m = static_cast<Mesh*>(Heap.Resolve(mesh));
+}
@@ -0,0 +1,484 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Shared Frame Memory Budget
+
+// Objetivo:
+// Repartir un único presupuesto de memoria por dominio entre varios
+// procesos de la misma máquina (servidores headless), con contadores
+// en memoria compartida y reservas atómicas.
+
+// Filosofía:
+// - La máquina tiene un sobre fijo de memoria: se reparte, no se adivina
+// - Reservar es un CAS, nunca un lock entre procesos
+// - Todo lo que reserva un proceso queda a nombre de su concesión (lease)
+// - Un proceso caído o colgado devuelve lo suyo por caducidad
+
+#pragma once
+
+#include "TXFrameMemoryBudget.cpp"
+
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace TX
+{
+
+constexpr uint32_t SHARED_FRAME_MEMORY_MAGIC      = 0x54584D53;   // 'TXMS'
+constexpr uint32_t SHARED_FRAME_MEMORY_VERSION    = 2;
+constexpr uint32_t SHARED_FRAME_MEMORY_MAX_LEASES = 32;
+
+// Los contadores de una concesión llevan su generación en los bits altos:
+// cobrar es un CAS que falla si la concesión se recuperó entretanto
+constexpr uint32_t SHARED_FRAME_MEMORY_GENERATION_SHIFT = 48;
+constexpr uint64_t SHARED_FRAME_MEMORY_BYTES_MASK       = (1ull << SHARED_FRAME_MEMORY_GENERATION_SHIFT) - 1;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "los contadores compartidos deben ser lock-free");
+
+// Concesión de un proceso: lo que tiene reservado ahora por dominio
+struct SharedFrameMemoryLease
+{
+    std::atomic<uint64_t> Owner;       // (pid << 32) | nonce; 0 = libre
+    std::atomic<uint64_t> HeartbeatNs; // CLOCK_MONOTONIC, común a toda la máquina
+    std::atomic<uint64_t> Generation;  // sube en cada adquisición y recuperación
+    std::atomic<uint64_t> Bytes[(uint8_t)FrameMemoryDomain::Count];   // (generación << 48) | bytes
+};
+
+// Segmento compartido (shm_open). ftruncate lo deja a cero: estado inicial válido.
+struct SharedFrameMemorySegment
+{
+    std::atomic<uint32_t> InitState;   // 0 = vacío, 1 = inicializando, 2 = listo
+    std::atomic<uint64_t> Initializer; // token de quien inicializa (pid en los bits altos)
+    uint32_t              Magic;
+    uint32_t              Version;
+    uint64_t              MaxBytes[(uint8_t)FrameMemoryDomain::Count];
+    std::atomic<uint64_t> UsedBytes[(uint8_t)FrameMemoryDomain::Count];
+    std::atomic<uint64_t> ReclaimedBytes;
+    SharedFrameMemoryLease Leases[SHARED_FRAME_MEMORY_MAX_LEASES];
+};
+
+// Presupuesto por dominio compartido entre procesos.
+// Misma semántica por frame que FrameMemoryBudgetSystem: BeginFrame
+// devuelve todo lo que el proceso reservó en el frame anterior.
+class SharedFrameMemoryBudgetSystem
+{
+public:
+    SharedFrameMemoryBudgetSystem() = default;
+    SharedFrameMemoryBudgetSystem(const SharedFrameMemoryBudgetSystem&) = delete;
+    SharedFrameMemoryBudgetSystem& operator=(const SharedFrameMemoryBudgetSystem&) = delete;
+
+    ~SharedFrameMemoryBudgetSystem()
+    {
+        Close();
+    }
+
+    // Abre (o crea) el segmento. El primer proceso fija el reparto por
+    // dominio con los mismos porcentajes que FrameMemoryBudgetSystem;
+    // los demás heredan el suyo e ignoran totalFrameBudget.
+    bool Open(const char* name, uint64_t totalFrameBudget, uint32_t leaseTimeoutMs = 2000)
+    {
+        Close();
+        LeaseTimeoutNs = (uint64_t)leaseTimeoutMs * 1000000ull;
+
+#if defined(__linux__)
+        const int fd = shm_open(name, O_CREAT | O_RDWR, 0600);
+        if (fd < 0)
+            return false;
+
+        const bool sized = ftruncate(fd, sizeof(SharedFrameMemorySegment)) == 0;
+        void* mapped = sized ? mmap(nullptr, sizeof(SharedFrameMemorySegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                             : MAP_FAILED;
+        close(fd);
+
+        if (mapped == MAP_FAILED)
+            return false;
+
+        Segment = static_cast<SharedFrameMemorySegment*>(mapped);
+        Token   = MakeToken();
+
+        uint32_t expected = 0;
+        if (Segment->InitState.compare_exchange_strong(expected, 1, std::memory_order_acq_rel))
+        {
+            Segment->Initializer.store(Token, std::memory_order_release);
+            InitializeSegment(totalFrameBudget, Token);
+        }
+
+        // Si quien inicializa muere o se cuelga, otro proceso toma el
+        // relevo: el CAS sobre Initializer elige a uno solo
+        uint64_t waitStart = NowNs();
+        uint64_t observed  = Segment->Initializer.load(std::memory_order_acquire);
+        while (Segment->InitState.load(std::memory_order_acquire) != 2)
+        {
+            // El plazo corre desde el último relevo visto
+            uint64_t initializer = Segment->Initializer.load(std::memory_order_acquire);
+            if (initializer != observed)
+            {
+                observed  = initializer;
+                waitStart = NowNs();
+            }
+
+            const bool dead    = initializer != 0 && !IsProcessAlive((uint32_t)(initializer >> 32));
+            const bool stalled = NowNs() - waitStart > LeaseTimeoutNs;
+
+            if ((dead || stalled) &&
+                Segment->Initializer.compare_exchange_strong(initializer, Token, std::memory_order_acq_rel))
+            {
+                InitializeSegment(totalFrameBudget, Token);
+                continue;
+            }
+
+            std::this_thread::yield();
+        }
+
+        if (Segment->Magic != SHARED_FRAME_MEMORY_MAGIC || Segment->Version != SHARED_FRAME_MEMORY_VERSION)
+        {
+            Close();
+            return false;
+        }
+
+        return AcquireLease();
+#else
+        (void)name;
+        (void)totalFrameBudget;
+        return false;
+#endif
+    }
+
+    // Devuelve lo reservado, libera la concesión y desmapea
+    void Close()
+    {
+        if (!Segment)
+            return;
+
+        if (OwnsLease())
+        {
+            ReleaseAll();
+            Lease->Owner.store(0, std::memory_order_release);
+        }
+
+#if defined(__linux__)
+        munmap(Segment, sizeof(SharedFrameMemorySegment));
+#endif
+        Segment    = nullptr;
+        Lease      = nullptr;
+        Token      = 0;
+        Generation = 0;
+    }
+
+    // Borra el segmento del sistema (lo hace el orquestador, no cada proceso)
+    static void Unlink(const char* name)
+    {
+#if defined(__linux__)
+        shm_unlink(name);
+#else
+        (void)name;
+#endif
+    }
+
+    // Inicio de frame: latido, devolución de lo reservado y recuperación
+    // de concesiones caducadas
+    void BeginFrame()
+    {
+        if (!Segment)
+            return;
+
+        // Si otro proceso nos dio por muertos, lo reservado ya se devolvió
+        if (!OwnsLease() && !AcquireLease())
+            return;
+
+        Lease->HeartbeatNs.store(NowNs(), std::memory_order_relaxed);
+        ReleaseAll();
+        ReclaimExpiredLeases();
+    }
+
+    // Reserva atómica contra el presupuesto de toda la máquina
+    bool Request(FrameMemoryDomain domain, uint64_t bytes)
+    {
+        if (!Segment || !OwnsLease() || bytes > SHARED_FRAME_MEMORY_BYTES_MASK)
+            return false;
+
+        const uint8_t d = (uint8_t)domain;
+        std::atomic<uint64_t>& used = Segment->UsedBytes[d];
+
+        for (uint32_t attempt = 0; attempt < 2; ++attempt)
+        {
+            uint64_t current = used.load(std::memory_order_relaxed);
+            while (current + bytes <= Segment->MaxBytes[d])
+            {
+                if (used.compare_exchange_weak(current, current + bytes, std::memory_order_acq_rel))
+                {
+                    // Ventana de unas instrucciones: si el proceso muere
+                    // aquí esos bytes no se recuperan hasta recrear el segmento
+                    if (ChargeLease(d, bytes))
+                        return true;
+
+                    // La concesión se recuperó entre medias: lo cobrado
+                    // globalmente no tiene dueño, se devuelve
+                    used.fetch_sub(bytes, std::memory_order_acq_rel);
+                    return false;
+                }
+            }
+
+            // Sin sitio: quizá un proceso caído retiene presupuesto
+            if (attempt == 0 && ReclaimExpiredLeases() == 0)
+                break;
+        }
+
+        return false;
+    }
+
+    void Release(FrameMemoryDomain domain, uint64_t bytes)
+    {
+        if (!Segment || !OwnsLease())
+            return;
+
+        const uint8_t d = (uint8_t)domain;
+        std::atomic<uint64_t>& counter = Lease->Bytes[d];
+
+        uint64_t current = counter.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if ((current & ~SHARED_FRAME_MEMORY_BYTES_MASK) != Generation)
+                return;
+
+            const uint64_t held  = current & SHARED_FRAME_MEMORY_BYTES_MASK;
+            const uint64_t freed = (bytes < held) ? bytes : held;
+            if (counter.compare_exchange_weak(current, current - freed, std::memory_order_acq_rel))
+            {
+                Segment->UsedBytes[d].fetch_sub(freed, std::memory_order_acq_rel);
+                return;
+            }
+        }
+    }
+
+    // Consultas (estado de toda la máquina)
+    uint64_t GetRemaining(FrameMemoryDomain domain) const
+    {
+        if (!Segment)
+            return 0;
+
+        const uint64_t used = Segment->UsedBytes[(uint8_t)domain].load(std::memory_order_relaxed);
+        const uint64_t max  = Segment->MaxBytes[(uint8_t)domain];
+        return (max > used) ? max - used : 0;
+    }
+
+    float GetUsageRatio(FrameMemoryDomain domain) const
+    {
+        if (!Segment || Segment->MaxBytes[(uint8_t)domain] == 0)
+            return 0.0f;
+        return (float)Segment->UsedBytes[(uint8_t)domain].load(std::memory_order_relaxed) /
+               (float)Segment->MaxBytes[(uint8_t)domain];
+    }
+
+    bool IsDomainCritical(FrameMemoryDomain domain) const
+    {
+        return GetUsageRatio(domain) > 0.9f;
+    }
+
+    // Lo reservado por este proceso
+    uint64_t GetLocalBytes(FrameMemoryDomain domain) const
+    {
+        return OwnsLease() ? Lease->Bytes[(uint8_t)domain].load(std::memory_order_relaxed) & SHARED_FRAME_MEMORY_BYTES_MASK : 0;
+    }
+
+    // Bytes devueltos por concesiones caducadas desde que existe el segmento
+    uint64_t GetReclaimedBytes() const
+    {
+        return Segment ? Segment->ReclaimedBytes.load(std::memory_order_relaxed) : 0;
+    }
+
+    bool IsOpen() const { return Segment != nullptr; }
+
+    // Recupera concesiones de procesos muertos o sin latido; devuelve los bytes liberados
+    uint64_t ReclaimExpiredLeases()
+    {
+        if (!Segment)
+            return 0;
+
+        const uint64_t now = NowNs();
+        uint64_t reclaimed = 0;
+
+        for (SharedFrameMemoryLease& lease : Segment->Leases)
+        {
+            uint64_t owner = lease.Owner.load(std::memory_order_acquire);
+            if (owner == 0 || owner == Token)
+                continue;
+
+            const uint64_t heartbeat = lease.HeartbeatNs.load(std::memory_order_relaxed);
+            const bool     timedOut  = now > heartbeat && now - heartbeat > LeaseTimeoutNs;
+            if (!timedOut && IsProcessAlive((uint32_t)(owner >> 32)))
+                continue;
+
+            // Solo un proceso recupera cada concesión. La generación nueva
+            // invalida cualquier cobro en curso del dueño anterior: su CAS
+            // falla y devuelve él mismo lo que reservó globalmente.
+            if (!lease.Owner.compare_exchange_strong(owner, RECLAIMING, std::memory_order_acq_rel))
+                continue;
+
+            const uint64_t generation = NextGeneration(lease);
+            for (uint8_t d = 0; d < (uint8_t)FrameMemoryDomain::Count; ++d)
+            {
+                const uint64_t bytes = lease.Bytes[d].exchange(generation, std::memory_order_acq_rel) & SHARED_FRAME_MEMORY_BYTES_MASK;
+                Segment->UsedBytes[d].fetch_sub(bytes, std::memory_order_acq_rel);
+                reclaimed += bytes;
+            }
+
+            lease.Owner.store(0, std::memory_order_release);
+        }
+
+        Segment->ReclaimedBytes.fetch_add(reclaimed, std::memory_order_relaxed);
+        return reclaimed;
+    }
+
+private:
+    static constexpr uint64_t RECLAIMING = ~0ull;
+
+    static uint64_t NowNs()
+    {
+#if defined(__linux__)
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#else
+        return 0;
+#endif
+    }
+
+    // El nonce distingue concesiones sucesivas del mismo pid
+    static uint64_t MakeToken()
+    {
+#if defined(__linux__)
+        return ((uint64_t)getpid() << 32) | (uint32_t)(NowNs() | 1);
+#else
+        return 1;
+#endif
+    }
+
+    // Generación siguiente ya desplazada a los bits altos (nunca 0)
+    static uint64_t NextGeneration(SharedFrameMemoryLease& lease)
+    {
+        const uint64_t limit = 1ull << (64 - SHARED_FRAME_MEMORY_GENERATION_SHIFT);
+        uint64_t generation = (lease.Generation.fetch_add(1, std::memory_order_acq_rel) + 1) % limit;
+        return (generation ? generation : 1) << SHARED_FRAME_MEMORY_GENERATION_SHIFT;
+    }
+
+    // Reparto por dominio; solo publica quien sigue siendo el inicializador
+    void InitializeSegment(uint64_t totalFrameBudget, uint64_t token)
+    {
+        FrameMemoryBudgetSystem layout;
+        layout.Initialize(totalFrameBudget);
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+            Segment->MaxBytes[i] = layout.GetRemaining((FrameMemoryDomain)i);
+
+        Segment->Magic   = SHARED_FRAME_MEMORY_MAGIC;
+        Segment->Version = SHARED_FRAME_MEMORY_VERSION;
+
+        if (Segment->Initializer.load(std::memory_order_acquire) == token)
+            Segment->InitState.store(2, std::memory_order_release);
+    }
+
+    // Suma a la concesión solo si sigue siendo la misma generación
+    bool ChargeLease(uint8_t d, uint64_t bytes)
+    {
+        std::atomic<uint64_t>& counter = Lease->Bytes[d];
+
+        uint64_t current = counter.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if ((current & ~SHARED_FRAME_MEMORY_BYTES_MASK) != Generation ||
+                (current & SHARED_FRAME_MEMORY_BYTES_MASK) + bytes > SHARED_FRAME_MEMORY_BYTES_MASK)
+                return false;
+
+            if (counter.compare_exchange_weak(current, current + bytes, std::memory_order_acq_rel))
+                return true;
+        }
+    }
+
+    static bool IsProcessAlive(uint32_t pid)
+    {
+#if defined(__linux__)
+        return kill((pid_t)pid, 0) == 0 || errno != ESRCH;
+#else
+        (void)pid;
+        return true;
+#endif
+    }
+
+    bool OwnsLease() const
+    {
+        return Lease && Lease->Owner.load(std::memory_order_acquire) == Token;
+    }
+
+    bool AcquireLease()
+    {
+        Token = MakeToken();
+        Lease = nullptr;
+
+        for (uint32_t pass = 0; pass < 2; ++pass)
+        {
+            for (SharedFrameMemoryLease& lease : Segment->Leases)
+            {
+                uint64_t expected = 0;
+                if (!lease.Owner.compare_exchange_strong(expected, Token, std::memory_order_acq_rel))
+                    continue;
+
+                // Contadores a cero con la generación propia: un cobro
+                // rezagado del dueño anterior ya no encaja
+                Generation = NextGeneration(lease);
+                for (std::atomic<uint64_t>& bytes : lease.Bytes)
+                    bytes.store(Generation, std::memory_order_release);
+
+                lease.HeartbeatNs.store(NowNs(), std::memory_order_relaxed);
+                Lease = &lease;
+                return true;
+            }
+
+            // Tabla llena: recuperar concesiones caducadas y reintentar
+            ReclaimExpiredLeases();
+        }
+
+        return false;
+    }
+
+    // Devuelve lo de la generación propia; si otro ya la recuperó no toca nada
+    void ReleaseAll()
+    {
+        for (uint8_t d = 0; d < (uint8_t)FrameMemoryDomain::Count; ++d)
+        {
+            std::atomic<uint64_t>& counter = Lease->Bytes[d];
+
+            uint64_t current = counter.load(std::memory_order_relaxed);
+            while ((current & ~SHARED_FRAME_MEMORY_BYTES_MASK) == Generation &&
+                   (current & SHARED_FRAME_MEMORY_BYTES_MASK) != 0)
+            {
+                if (counter.compare_exchange_weak(current, Generation, std::memory_order_acq_rel))
+                {
+                    Segment->UsedBytes[d].fetch_sub(current & SHARED_FRAME_MEMORY_BYTES_MASK, std::memory_order_acq_rel);
+                    break;
+                }
+            }
+        }
+    }
+
+    SharedFrameMemorySegment* Segment = nullptr;
+    SharedFrameMemoryLease*   Lease   = nullptr;
+    uint64_t                  Token   = 0;
+    uint64_t                  Generation = 0;   // ya desplazada a los bits altos
+    uint64_t                  LeaseTimeoutNs = 0;
+};
+
+
+// Ejemplo de uso
+// SharedMemory.Open("/tx_sim_budget", 8ull * 1024 * MB);
+// SharedMemory.BeginFrame();
+// if (!SharedMemory.Request(FrameMemoryDomain::Physics, islandBytes)) SimplifyIsland();
+}
@@ -0,0 +1,307 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Simulation Error Budget
+
+// Objetivo:
+// Extender el presupuesto de error a la simulación: iteraciones del
+// solver, substeps y precisión de colisión. Las islas de física lejanas
+// o fuera de pantalla piden menos fidelidad a cambio de error acotado.
+// La frecuencia de actualización de animación e IA también se cobra
+// aquí (ver TXUpdateRateScheduler).
+
+// Filosofía:
+// - El error de simulación solo importa si se percibe
+// - Una isla fuera de pantalla puede equivocarse más que una en primer plano
+// - La fidelidad se reduce por escalones, nunca por debajo de lo estable
+// - Cada milisegundo ahorrado queda medido por isla
+
+#pragma once
+
+#include "TXErrorBudget.cpp"
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace TX
+{
+
+// Tipos de error de simulación
+enum class SimulationErrorType : uint8_t
+{
+    SolverIterations,    // convergencia del solver de restricciones
+    Substeps,            // integración con paso más grande
+    CollisionPrecision,  // colisión discreta en lugar de continua (CCD)
+    AnimationUpdate,     // poses saltadas / interpoladas
+    AIUpdate,            // ticks de IA espaciados
+    Count
+};
+
+static constexpr uint32_t SIMULATION_ERROR_TYPE_COUNT = static_cast<uint32_t>(SimulationErrorType::Count);
+
+// Mismo sistema que ErrorBudgetSystem, con tipos de simulación y sin
+// acumulación temporal. BeginFrame conserva los límites ajustados.
+struct SimulationErrorTraits
+{
+    using Type = SimulationErrorType;
+    static constexpr uint32_t Count         = SIMULATION_ERROR_TYPE_COUNT;
+    static constexpr uint32_t TemporalIndex = Count;
+
+    // Límites base (tuneables por plataforma)
+    static constexpr float BaseLimits[Count] =
+    {
+        0.5f, // SolverIterations
+        0.5f, // Substeps
+        0.3f, // CollisionPrecision
+        0.6f, // AnimationUpdate
+        0.8f  // AIUpdate
+    };
+};
+
+using SimulationErrorBudgetSystem = BasicErrorBudgetSystem<SimulationErrorTraits>;
+using SimulationErrorBudgetMark   = BasicErrorBudgetMark<SimulationErrorTraits>;
+using SimulationErrorBudgetScope  = BasicErrorBudgetScope<SimulationErrorTraits>;
+
+// Isla de física tal como la ve el planificador
+struct PhysicsIslandDesc
+{
+    float    Distance;            // a la cámara (m)
+    float    ScreenCoverage;      // fracción de pantalla; 0 = fuera de pantalla
+    float    MaxSpeed;            // velocidad del cuerpo más rápido (m/s)
+    float    MinExtent;           // tamaño del cuerpo más pequeño (m)
+    uint32_t BodyCount;
+    uint16_t FullIterations;      // fidelidad completa
+    uint8_t  FullSubsteps;
+    bool     FullContinuous;      // CCD a fidelidad completa
+};
+
+// Fidelidad concedida a una isla
+struct PhysicsIslandFidelity
+{
+    uint16_t SolverIterations;
+    uint8_t  Substeps;
+    bool     Continuous;
+    uint8_t  Tier;                // 0 = completa
+    float    Error[SIMULATION_ERROR_TYPE_COUNT];
+    float    CpuSavedUs;
+};
+
+// Coste de CPU por cuerpo (calibrar por plataforma)
+struct PhysicsCostModel
+{
+    float SolverIterationUs = 0.08f;   // por cuerpo, iteración y substep
+    float IntegrationUs     = 0.05f;   // por cuerpo y substep
+    float ContinuousFactor  = 2.5f;    // CCD frente a colisión discreta
+    float FrameDt           = 1.0f / 60.0f;
+};
+
+// Planificador de fidelidad por isla.
+// Se baja un escalón cada vez a todas las islas, de la menos perceptible
+// a la más: los primeros escalones ahorran más CPU por unidad de error,
+// así que se reparten antes de hundir unas pocas islas hasta el fondo.
+class SimulationFidelityPlanner
+{
+public:
+    void SetCostModel(const PhysicsCostModel& model) { Model = model; }
+
+    // Error máximo de una sola isla: ninguna isla se aleja tanto
+    // aunque el presupuesto total lo permita
+    void SetMaxIslandError(float maxError) { MaxIslandError = maxError; }
+
+    void Plan(const PhysicsIslandDesc* islands, uint32_t count, SimulationErrorBudgetSystem& budget)
+    {
+        Fidelity.resize(count);
+        Order.resize(count);
+        Weights.resize(count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Order[i]   = i;
+            Weights[i] = Perceptibility(islands[i]);
+        }
+
+        std::stable_sort(Order.begin(), Order.end(), [this](uint32_t a, uint32_t b)
+        {
+            return Weights[a] < Weights[b];
+        });
+
+        TotalCpuUs      = 0.0f;
+        TotalCpuSavedUs = 0.0f;
+        MaxError        = 0.0f;
+        ReducedIslands  = 0;
+
+        for (uint32_t i = 0; i < count; ++i)
+            BuildTier(islands[i], 0, Weights[i], Fidelity[i]);
+
+        for (uint8_t tier = 1; tier < TIER_COUNT; ++tier)
+        {
+            for (uint32_t index : Order)
+            {
+                PhysicsIslandFidelity& fidelity = Fidelity[index];
+                if (fidelity.Tier != tier - 1)
+                    continue;
+
+                PhysicsIslandFidelity candidate;
+                BuildTier(islands[index], tier, Weights[index], candidate);
+                if (TryCharge(fidelity, candidate, budget))
+                    fidelity = candidate;
+            }
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const PhysicsIslandDesc& island = islands[i];
+            PhysicsIslandFidelity& fidelity = Fidelity[i];
+
+            const float fullCost = CpuCost(island, island.FullIterations, island.FullSubsteps, island.FullContinuous);
+            const float cost     = CpuCost(island, fidelity.SolverIterations, fidelity.Substeps, fidelity.Continuous);
+            fidelity.CpuSavedUs  = fullCost - cost;
+
+            TotalCpuUs      += cost;
+            TotalCpuSavedUs += fidelity.CpuSavedUs;
+            ReducedIslands  += fidelity.Tier > 0;
+            for (uint32_t t = 0; t < SIMULATION_ERROR_TYPE_COUNT; ++t)
+                MaxError = std::max(MaxError, fidelity.Error[t]);
+        }
+    }
+
+    const PhysicsIslandFidelity& GetFidelity(uint32_t island) const { return Fidelity[island]; }
+
+    // Telemetría (CPU ahorrada por isla en GetFidelity().CpuSavedUs)
+    float    GetTotalCpuUs() const      { return TotalCpuUs; }
+    float    GetTotalCpuSavedUs() const { return TotalCpuSavedUs; }
+    float    GetMaxIslandError() const  { return MaxError; }
+    uint32_t GetReducedIslands() const  { return ReducedIslands; }
+
+private:
+    static constexpr uint8_t TIER_COUNT = 4;
+
+    // Fracción de la fidelidad completa por escalón
+    static constexpr float TierScale[TIER_COUNT] = { 1.0f, 0.75f, 0.5f, 0.25f };
+
+    // Cuánto se nota un error en esta isla: cobertura en pantalla
+    // (con un suelo para lo que está fuera) atenuada con la distancia
+    static float Perceptibility(const PhysicsIslandDesc& island)
+    {
+        const float coverage = std::max(island.ScreenCoverage, 0.02f);
+        return coverage / (1.0f + island.Distance * 0.02f);
+    }
+
+    void BuildTier(const PhysicsIslandDesc& island, uint8_t tier, float weight, PhysicsIslandFidelity& fidelity) const
+    {
+        const float scale = TierScale[tier];
+
+        std::fill(fidelity.Error, fidelity.Error + SIMULATION_ERROR_TYPE_COUNT, 0.0f);
+
+        // Una isla sin iteraciones o sin substeps (dormida, cinemática)
+        // no tiene nada que reducir: se queda en cero y sin error
+        fidelity.Tier             = tier;
+        fidelity.SolverIterations = island.FullIterations ? (uint16_t)std::max(1.0f, std::ceil(island.FullIterations * scale)) : 0;
+        fidelity.Substeps         = island.FullSubsteps ? (uint8_t)std::max(1.0f, std::ceil(island.FullSubsteps * scale)) : 0;
+        fidelity.Continuous       = island.FullContinuous && tier < 2;
+
+        // Error relativo de cada reducción, ponderado por lo que se percibe
+        const float iterationError = fidelity.SolverIterations ? (float)island.FullIterations / fidelity.SolverIterations - 1.0f : 0.0f;
+        const float substepError   = fidelity.Substeps ? (float)island.FullSubsteps / fidelity.Substeps - 1.0f : 0.0f;
+
+        // Sin CCD: riesgo de atravesar = avance por substep frente al tamaño
+        float tunnelError = 0.0f;
+        if (island.FullContinuous && !fidelity.Continuous)
+        {
+            const float travel = island.MaxSpeed * Model.FrameDt / std::max<uint8_t>(fidelity.Substeps, 1);
+            tunnelError = std::min(1.0f, travel / std::max(island.MinExtent, 0.001f));
+        }
+
+        fidelity.Error[(uint32_t)SimulationErrorType::SolverIterations]   = weight * iterationError;
+        fidelity.Error[(uint32_t)SimulationErrorType::Substeps]           = weight * substepError;
+        fidelity.Error[(uint32_t)SimulationErrorType::CollisionPrecision] = weight * tunnelError;
+    }
+
+    // Cobra solo el error extra del escalón nuevo
+    bool TryCharge(const PhysicsIslandFidelity& current, const PhysicsIslandFidelity& candidate,
+                   SimulationErrorBudgetSystem& budget) const
+    {
+        for (uint32_t t = 0; t < SIMULATION_ERROR_TYPE_COUNT; ++t)
+        {
+            if (candidate.Error[t] > MaxIslandError)
+                return false;
+        }
+
+        const SimulationErrorBudgetMark mark = budget.GetMark();
+        for (uint32_t t = 0; t < SIMULATION_ERROR_TYPE_COUNT; ++t)
+        {
+            if (!budget.Request((SimulationErrorType)t, candidate.Error[t] - current.Error[t]))
+            {
+                budget.Rollback(mark);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    float CpuCost(const PhysicsIslandDesc& island, uint32_t iterations, uint32_t substeps, bool continuous) const
+    {
+        const float collision = continuous ? Model.ContinuousFactor : 1.0f;
+        return island.BodyCount * substeps * (iterations * Model.SolverIterationUs + Model.IntegrationUs * collision);
+    }
+
+    std::vector<PhysicsIslandFidelity> Fidelity;
+    std::vector<uint32_t>              Order;
+    std::vector<float>                 Weights;
+
+    PhysicsCostModel Model;
+    float    MaxIslandError  = 0.05f;
+    float    TotalCpuUs      = 0.0f;
+    float    TotalCpuSavedUs = 0.0f;
+    float    MaxError        = 0.0f;
+    uint32_t ReducedIslands  = 0;
+};
+
+
+// Benchmark del planificador: CPU de física ahorrada frente a la
+// fidelidad completa, por isla reducida, con el error que cuesta
+struct SimulationFidelityBenchmarkResult
+{
+    double   PlanUs;                    // media por Plan
+    float    FullCpuUs;                 // todas las islas a fidelidad completa
+    float    CpuUs;                     // con la fidelidad planificada
+    float    CpuSavedPerReducedIslandUs;
+    float    MaxIslandError;
+    uint32_t ReducedIslands;
+};
+
+inline SimulationFidelityBenchmarkResult RunSimulationFidelityBenchmark(const PhysicsIslandDesc* islands, uint32_t count,
+                                                                        uint32_t iterations,
+                                                                        const PhysicsCostModel& model = PhysicsCostModel())
+{
+    SimulationFidelityBenchmarkResult result = {};
+
+    SimulationErrorBudgetSystem budget;
+    SimulationFidelityPlanner   planner;
+    planner.SetCostModel(model);
+    iterations = std::max<uint32_t>(1, iterations);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        budget.BeginFrame();
+        planner.Plan(islands, count, budget);
+    }
+    result.PlanUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    result.CpuUs          = planner.GetTotalCpuUs();
+    result.FullCpuUs      = result.CpuUs + planner.GetTotalCpuSavedUs();
+    result.MaxIslandError = planner.GetMaxIslandError();
+    result.ReducedIslands = planner.GetReducedIslands();
+    if (result.ReducedIslands > 0)
+        result.CpuSavedPerReducedIslandUs = planner.GetTotalCpuSavedUs() / result.ReducedIslands;
+    return result;
+}
+
+// Ejemplo de uso
+// SimulationBudget.BeginFrame();
+// Fidelity.Plan(islands, islandCount, SimulationBudget);
+// const PhysicsIslandFidelity& f = Fidelity.GetFidelity(i);
+// Solver.Step(island[i], f.SolverIterations, f.Substeps, f.Continuous);
+}
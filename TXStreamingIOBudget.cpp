@@ -0,0 +1,566 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Streaming I/O Budget
+
+// Objetivo:
+// Presupuestar los bytes leídos de disco por frame y por dominio,
+// igual que FrameMemoryBudgetSystem presupuesta la memoria, y emitir
+// las lecturas por prioridad solo cuando caben en ambos presupuestos.
+
+// Filosofía:
+// - Leer de disco también es gastar frame
+// - Una lectura sin memoria de destino es un hitch diferido
+// - Lo importante entra primero; lo demás espera al siguiente frame
+// - El backend (io_uring o hilos) es un detalle, el presupuesto no
+
+#pragma once
+
+#include "TXFrameMemoryBudget.cpp"
+
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// io_uring opcional: definir TX_STREAMING_IO_URING y enlazar liburing
+#if defined(TX_STREAMING_IO_URING) && defined(__linux__) && __has_include(<liburing.h>)
+#include <liburing.h>
+#define TX_STREAMING_HAS_IO_URING 1
+#else
+#define TX_STREAMING_HAS_IO_URING 0
+#endif
+
+namespace TX
+{
+
+// Presupuesto de lectura por dominio
+struct IOBudget
+{
+    uint64_t MaxBytes;
+    uint64_t ReadBytes;
+};
+
+// Ancho de banda de disco por frame (mismo modelo que FrameMemoryBudgetSystem)
+class IOBudgetSystem
+{
+public:
+    IOBudgetSystem()
+    {
+        Reset();
+    }
+
+    // Inicialización con bytes legibles por frame
+    void Initialize(uint64_t bytesPerFrame)
+    {
+        TotalBudget = bytesPerFrame;
+
+        // Distribución base: el streaming es casi todo texturas y geometría
+        Budgets[(uint8_t)FrameMemoryDomain::Textures]   = { bytesPerFrame * 50 / 100, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Geometry]   = { bytesPerFrame * 30 / 100, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Audio]      = { bytesPerFrame * 8  / 100, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Animation]  = { bytesPerFrame * 6  / 100, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Particles]  = { bytesPerFrame * 2  / 100, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::Physics]    = { bytesPerFrame * 2  / 100, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::AI]         = { bytesPerFrame * 1  / 100, 0 };
+        Budgets[(uint8_t)FrameMemoryDomain::UI]         = { bytesPerFrame * 1  / 100, 0 };
+    }
+
+    // Reinicio por frame
+    void BeginFrame()
+    {
+        for (uint8_t i = 0; i < (uint8_t)FrameMemoryDomain::Count; ++i)
+            Budgets[i].ReadBytes = 0;
+    }
+
+    // Solicitud de ancho de banda
+    bool Request(FrameMemoryDomain domain, uint64_t bytes)
+    {
+        IOBudget& budget = Budgets[(uint8_t)domain];
+
+        if (budget.ReadBytes + bytes > budget.MaxBytes)
+            return false;
+
+        budget.ReadBytes += bytes;
+        return true;
+    }
+
+    // Cobro sin comprobar la cuota: una lectura mayor que la cuota del
+    // dominio se admite sola y lo agota hasta el frame siguiente
+    void Charge(FrameMemoryDomain domain, uint64_t bytes)
+    {
+        Budgets[(uint8_t)domain].ReadBytes += bytes;
+    }
+
+    uint64_t GetRemaining(FrameMemoryDomain domain) const
+    {
+        const IOBudget& budget = Budgets[(uint8_t)domain];
+        return (budget.MaxBytes > budget.ReadBytes)
+             ? (budget.MaxBytes - budget.ReadBytes)
+             : 0;
+    }
+
+    uint64_t GetMaxBytes(FrameMemoryDomain domain) const  { return Budgets[(uint8_t)domain].MaxBytes; }
+    uint64_t GetReadBytes(FrameMemoryDomain domain) const { return Budgets[(uint8_t)domain].ReadBytes; }
+
+    float GetUsageRatio(FrameMemoryDomain domain) const
+    {
+        const IOBudget& budget = Budgets[(uint8_t)domain];
+        return (float)budget.ReadBytes / (float)budget.MaxBytes;
+    }
+
+    void Reset()
+    {
+        std::memset(Budgets, 0, sizeof(Budgets));
+        TotalBudget = 0;
+    }
+
+private:
+    IOBudget Budgets[(uint8_t)FrameMemoryDomain::Count];
+    uint64_t TotalBudget;
+};
+
+struct StreamingReadRequest;
+
+// Mayor lectura que el kernel completa en una sola llamada (MAX_RW_COUNT).
+// Con io_uring no se reintentan lecturas cortas: lo que exceda se rechaza.
+static constexpr uint64_t STREAMING_MAX_IO_URING_READ = 0x7ffff000ull;
+
+// Resultado: bytes leídos o -errno
+using StreamingReadCallback = void (*)(void* userData, const StreamingReadRequest& request, int64_t result);
+
+// Lectura asíncrona
+struct StreamingReadRequest
+{
+    int                   FileDescriptor;
+    uint64_t              Offset;
+    uint64_t              Bytes;
+    void*                 Destination;
+    FrameMemoryDomain     Domain;       // presupuesto de I/O y de memoria destino
+    uint32_t              Priority;     // mayor = antes
+    StreamingReadCallback OnComplete;
+    void*                 UserData;
+};
+
+// Cola de lecturas con admisión por presupuesto
+class StreamingReadQueue
+{
+public:
+    StreamingReadQueue() = default;
+
+    ~StreamingReadQueue()
+    {
+        Shutdown();
+    }
+
+    StreamingReadQueue(const StreamingReadQueue&) = delete;
+    StreamingReadQueue& operator=(const StreamingReadQueue&) = delete;
+
+    // queueDepth: lecturas en vuelo como máximo.
+    // allowIoUring = false fuerza el respaldo con pread en hilos.
+    void Initialize(uint32_t queueDepth = 64, uint32_t workerThreads = 2, bool allowIoUring = true)
+    {
+        Shutdown();
+        QueueDepth = queueDepth ? queueDepth : 1;
+
+        (void)allowIoUring;
+#if TX_STREAMING_HAS_IO_URING
+        UsingIoUring = allowIoUring && io_uring_queue_init(QueueDepth, &Ring, 0) == 0;
+        if (UsingIoUring)
+            return;
+#endif
+
+        Running = true;
+        for (uint32_t i = 0; i < std::max(1u, workerThreads); ++i)
+            Workers.emplace_back(&StreamingReadQueue::WorkerLoop, this);
+    }
+
+    void Shutdown()
+    {
+#if TX_STREAMING_HAS_IO_URING
+        if (UsingIoUring)
+        {
+            // Drenar todas las lecturas en vuelo antes de cerrar el anillo
+            while (InFlight > 0)
+                if (PollCompletions() == 0)
+                    std::this_thread::yield();
+            io_uring_queue_exit(&Ring);
+            UsingIoUring = false;
+        }
+#endif
+
+        {
+            std::lock_guard<std::mutex> lock(JobsMutex);
+            Running = false;
+        }
+        JobsReady.notify_all();
+
+        for (std::thread& worker : Workers)
+            worker.join();
+        Workers.clear();
+
+        PollCompletions();
+        Jobs.clear();
+    }
+
+    // Encolar (no consume presupuesto hasta Update). Con io_uring una
+    // lectura mayor que STREAMING_MAX_IO_URING_READ se rechaza: el
+    // llamador la parte en trozos.
+    bool Submit(const StreamingReadRequest& request)
+    {
+        if (UsingIoUring && request.Bytes > STREAMING_MAX_IO_URING_READ)
+            return false;
+
+        Pending.push_back({ request, NextSequence++ });
+        std::push_heap(Pending.begin(), Pending.end(), PendingOrder());
+        return true;
+    }
+
+    // Emite lecturas por prioridad mientras quepan en I/O y en memoria destino.
+    // Un dominio bloqueado no frena a los demás; sus lecturas esperan
+    // al siguiente frame conservando el orden. Una lectura mayor que la
+    // cuota de I/O del dominio sale sola, con el dominio sin lecturas en
+    // vuelo ni bytes leídos este frame; si no, no saldría nunca.
+    uint32_t Update(IOBudgetSystem& io, FrameMemoryBudgetSystem& memory)
+    {
+        bool blocked[(uint8_t)FrameMemoryDomain::Count] = {};
+        uint32_t issued = 0;
+
+        Deferred.clear();
+        while (!Pending.empty() && InFlight < QueueDepth)
+        {
+            std::pop_heap(Pending.begin(), Pending.end(), PendingOrder());
+            const PendingRead pending = Pending.back();
+            Pending.pop_back();
+
+            const StreamingReadRequest& request = pending.Request;
+            const uint8_t domain = (uint8_t)request.Domain;
+
+            const bool oversized = request.Bytes > io.GetMaxBytes(request.Domain);
+            const bool fitsIo    = oversized
+                ? InFlightByDomain[domain] == 0 && io.GetReadBytes(request.Domain) == 0
+                : io.GetRemaining(request.Domain) >= request.Bytes;
+
+            if (blocked[domain] || !fitsIo ||
+                memory.GetRemaining(request.Domain) < request.Bytes)
+            {
+                blocked[domain] = true;
+                Deferred.push_back(pending);
+                continue;
+            }
+
+            // Se cobra solo lo que de verdad salió
+            if (!Dispatch(request))
+            {
+                Deferred.push_back(pending);
+                break;
+            }
+
+            io.Charge(request.Domain, request.Bytes);
+            memory.Request(request.Domain, request.Bytes);
+
+            ++InFlightByDomain[domain];
+            ++InFlight;
+            ++issued;
+        }
+
+        for (const PendingRead& pending : Deferred)
+        {
+            Pending.push_back(pending);
+            std::push_heap(Pending.begin(), Pending.end(), PendingOrder());
+        }
+
+        return issued;
+    }
+
+    // Entrega completadas en el hilo que llama (normalmente el principal)
+    uint32_t PollCompletions()
+    {
+        uint32_t completed = 0;
+
+#if TX_STREAMING_HAS_IO_URING
+        if (UsingIoUring)
+        {
+            io_uring_cqe* cqe = nullptr;
+            while (io_uring_peek_cqe(&Ring, &cqe) == 0 && cqe)
+            {
+                StreamingReadRequest* request = static_cast<StreamingReadRequest*>(io_uring_cqe_get_data(cqe));
+                const int64_t result = cqe->res;
+                io_uring_cqe_seen(&Ring, cqe);
+
+                if (request->OnComplete)
+                    request->OnComplete(request->UserData, *request, result);
+                --InFlightByDomain[(uint8_t)request->Domain];
+                delete request;
+
+                --InFlight;
+                ++completed;
+            }
+            return completed;
+        }
+#endif
+
+        {
+            std::lock_guard<std::mutex> lock(CompletionsMutex);
+            Completed.swap(Delivering);
+        }
+
+        for (const CompletedRead& read : Delivering)
+        {
+            if (read.Request.OnComplete)
+                read.Request.OnComplete(read.Request.UserData, read.Request, read.Result);
+            --InFlightByDomain[(uint8_t)read.Request.Domain];
+            --InFlight;
+            ++completed;
+        }
+        Delivering.clear();
+
+        return completed;
+    }
+
+    // Telemetría
+    uint32_t GetPendingCount() const  { return (uint32_t)Pending.size(); }
+    uint32_t GetInFlightCount() const { return InFlight; }
+    bool     IsUsingIoUring() const   { return UsingIoUring; }
+
+private:
+    struct PendingRead
+    {
+        StreamingReadRequest Request;
+        uint64_t             Sequence;   // FIFO entre prioridades iguales
+    };
+
+    struct PendingOrder
+    {
+        bool operator()(const PendingRead& a, const PendingRead& b) const
+        {
+            if (a.Request.Priority != b.Request.Priority)
+                return a.Request.Priority < b.Request.Priority;
+            return a.Sequence > b.Sequence;
+        }
+    };
+
+    struct CompletedRead
+    {
+        StreamingReadRequest Request;
+        int64_t              Result;
+    };
+
+    bool Dispatch(const StreamingReadRequest& request)
+    {
+#if TX_STREAMING_HAS_IO_URING
+        if (UsingIoUring)
+        {
+            io_uring_sqe* sqe = io_uring_get_sqe(&Ring);
+            if (!sqe)
+                return false;
+
+            io_uring_prep_read(sqe, request.FileDescriptor, request.Destination,
+                               (unsigned)request.Bytes, request.Offset);
+            io_uring_sqe_set_data(sqe, new StreamingReadRequest(request));
+            io_uring_submit(&Ring);
+            return true;
+        }
+#endif
+
+        {
+            std::lock_guard<std::mutex> lock(JobsMutex);
+            Jobs.push_back(request);
+        }
+        JobsReady.notify_one();
+        return true;
+    }
+
+    // Respaldo sin io_uring: pread bloqueante en hilos
+    void WorkerLoop()
+    {
+        for (;;)
+        {
+            StreamingReadRequest request;
+            {
+                std::unique_lock<std::mutex> lock(JobsMutex);
+                JobsReady.wait(lock, [this] { return !Running || !Jobs.empty(); });
+                if (Jobs.empty())
+                    return;
+
+                request = Jobs.front();
+                Jobs.pop_front();
+            }
+
+            const int64_t result = ReadFully(request);
+
+            std::lock_guard<std::mutex> lock(CompletionsMutex);
+            Completed.push_back({ request, result });
+        }
+    }
+
+    static int64_t ReadFully(const StreamingReadRequest& request)
+    {
+        uint8_t* destination = static_cast<uint8_t*>(request.Destination);
+        uint64_t done = 0;
+
+        while (done < request.Bytes)
+        {
+            const ssize_t got = pread(request.FileDescriptor, destination + done,
+                                      request.Bytes - done, (off_t)(request.Offset + done));
+            if (got < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return -(int64_t)errno;
+            }
+            if (got == 0)
+                break;   // fin de fichero
+
+            done += (uint64_t)got;
+        }
+
+        return (int64_t)done;
+    }
+
+    std::vector<PendingRead> Pending;    // heap por prioridad
+    std::vector<PendingRead> Deferred;
+    uint64_t                 NextSequence = 0;
+    uint32_t                 QueueDepth   = 64;
+    uint32_t                 InFlight     = 0;
+    uint32_t                 InFlightByDomain[(uint8_t)FrameMemoryDomain::Count] = {};
+    bool                     UsingIoUring = false;
+
+#if TX_STREAMING_HAS_IO_URING
+    io_uring                 Ring;
+#endif
+
+    // Pool de hilos
+    std::vector<std::thread>         Workers;
+    std::deque<StreamingReadRequest> Jobs;
+    std::mutex                       JobsMutex;
+    std::condition_variable          JobsReady;
+    bool                             Running = false;
+
+    std::vector<CompletedRead>       Completed;
+    std::vector<CompletedRead>       Delivering;
+    std::mutex                       CompletionsMutex;
+};
+
+
+// Autocomprobación y benchmark: escribe un fichero temporal con un patrón
+// conocido y lo lee en trozos por io_uring (si está compilado y el kernel
+// lo permite) y por el respaldo con pread, verificando cada byte.
+struct StreamingIOBenchmarkResult
+{
+    bool     IoUringAvailable;   // false: solo se midió el respaldo
+    bool     IoUringVerified;
+    bool     PreadVerified;
+    double   IoUringMs;
+    double   PreadMs;
+    uint64_t FileBytes;
+};
+
+inline StreamingIOBenchmarkResult RunStreamingIOBenchmark(uint64_t fileBytes = 64ull << 20,
+                                                          uint64_t chunkBytes = 256ull << 10,
+                                                          uint32_t queueDepth = 64)
+{
+    StreamingIOBenchmarkResult result = {};
+    chunkBytes = std::max<uint64_t>(1, chunkBytes);
+
+    char path[] = "/tmp/tx_streaming_io_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0)
+        return result;
+    unlink(path);
+
+    std::vector<uint8_t> source(fileBytes);
+    for (uint64_t i = 0; i < fileBytes; ++i)
+        source[i] = (uint8_t)((i * 2654435761ull) >> 13);
+
+    for (uint64_t done = 0; done < fileBytes; )
+    {
+        const ssize_t wrote = write(fd, source.data() + done, fileBytes - done);
+        if (wrote <= 0)
+        {
+            close(fd);
+            return result;
+        }
+        done += (uint64_t)wrote;
+    }
+    result.FileBytes = fileBytes;
+
+    struct Tally
+    {
+        uint64_t Bytes;
+        uint32_t Errors;
+    };
+
+    auto onComplete = [](void* userData, const StreamingReadRequest& request, int64_t read)
+    {
+        Tally* tally = static_cast<Tally*>(userData);
+        if (read != (int64_t)request.Bytes)
+            ++tally->Errors;
+        else
+            tally->Bytes += (uint64_t)read;
+    };
+
+    // Todo en un frame: los presupuestos cubren el fichero entero
+    auto readAll = [&](bool allowIoUring, bool& usedIoUring, double& ms) -> bool
+    {
+        std::vector<uint8_t> destination(fileBytes);
+        Tally tally = {};
+
+        IOBudgetSystem io;
+        io.Initialize(fileBytes * 2);
+        FrameMemoryBudgetSystem memory;
+        memory.Initialize(fileBytes * 4);
+
+        StreamingReadQueue reads;
+        reads.Initialize(queueDepth, 2, allowIoUring);
+        usedIoUring = reads.IsUsingIoUring();
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (uint64_t offset = 0; offset < fileBytes; offset += chunkBytes)
+        {
+            const uint64_t bytes = std::min(chunkBytes, fileBytes - offset);
+            reads.Submit({ fd, offset, bytes, destination.data() + offset,
+                           FrameMemoryDomain::Textures, 0, onComplete, &tally });
+        }
+
+        while (reads.GetPendingCount() > 0 || reads.GetInFlightCount() > 0)
+        {
+            reads.Update(io, memory);
+            if (reads.PollCompletions() == 0)
+                std::this_thread::yield();
+        }
+
+        ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        reads.Shutdown();
+
+        return tally.Errors == 0 && tally.Bytes == fileBytes &&
+               std::memcmp(destination.data(), source.data(), fileBytes) == 0;
+    };
+
+    bool usedIoUring = false;
+    const bool ringVerified = readAll(true, usedIoUring, result.IoUringMs);
+    result.IoUringAvailable = usedIoUring;
+    result.IoUringVerified  = usedIoUring && ringVerified;
+    if (!usedIoUring)
+        result.IoUringMs = 0.0;
+
+    result.PreadVerified = readAll(false, usedIoUring, result.PreadMs);
+
+    close(fd);
+    return result;
+}
+
+
+// Ejemplo de uso
+// Reads.Submit({ fd, offset, size, dst, FrameMemoryDomain::Textures, priority, OnMipLoaded, tex });
+// Reads.Update(IOSystem, MemorySystem);
+// Reads.PollCompletions();
+}
@@ -0,0 +1,263 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Temporal Reuse Cache
+
+// Objetivo:
+// Recordar, por tile de pantalla u objeto, si se reutilizó la historia
+// (reproyección) y cuánto error Temporal costó, para que las regiones
+// estables repitan la decisión con un solo Request agrupado y solo lo
+// que cambia (velocidad, desoclusión) vuelva a pedir presupuesto.
+
+// Filosofía:
+// - Lo que no se mueve no necesita decidirse otra vez
+// - Una región cambia si cambia su velocidad o se desocluye
+// - Lo estable se cobra junto: una petición en lugar de miles
+// - Si lo estable ya no cabe, se vuelve a decidir todo
+
+#pragma once
+
+#include "TXErrorBudget.cpp"
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace TX
+{
+
+// Métricas de la región este frame (reducción del velocity buffer)
+struct TemporalReuseInput
+{
+    float Velocity;       // velocidad máxima en la región (px/frame)
+    float Disocclusion;   // fracción de píxeles sin historia válida (0..1)
+    float ReuseError;     // error Temporal si se reutiliza la historia
+};
+
+struct TemporalReuseThresholds
+{
+    float    VelocityDelta   = 0.5f;  // cambio de velocidad que invalida (px/frame)
+    float    MaxDisocclusion = 0.05f; // por encima siempre se reevalúa
+    uint32_t RefreshInterval = 16;    // cada región se reevalúa al menos una vez por intervalo
+};
+
+struct TemporalReuseStats
+{
+    uint32_t Regions;
+    uint32_t Stable;        // decisiones repetidas sin reevaluar
+    uint32_t Reevaluated;
+    uint32_t Reused;
+    uint32_t Requests;      // llamadas a ErrorBudgetSystem::Request
+};
+
+// Cache indexada por región (tile o id de objeto, lo decide el llamador)
+class TemporalReuseCache
+{
+public:
+    void SetThresholds(const TemporalReuseThresholds& thresholds)
+    {
+        Thresholds = thresholds;
+        Thresholds.RefreshInterval = std::max<uint32_t>(1, thresholds.RefreshInterval);
+    }
+
+    void Resize(uint32_t regionCount)
+    {
+        Entries.assign(regionCount, Entry());
+    }
+
+    // Fuerza reevaluar una región (corte de cámara, objeto teletransportado)
+    void Invalidate(uint32_t region)
+    {
+        Entries[region].Valid = false;
+    }
+
+    void InvalidateAll()
+    {
+        for (Entry& entry : Entries)
+            entry.Valid = false;
+    }
+
+    // Una vez por frame tras reducir el velocity buffer por región
+    void Update(const TemporalReuseInput* inputs, ErrorBudgetSystem& budget)
+    {
+        const uint32_t count = (uint32_t)Entries.size();
+        ++Frame;
+
+        Stats = {};
+        Stats.Regions = count;
+
+        // 1) Regiones estables: repiten decisión y se cobra su suma
+        float stableError = 0.0f;
+        Changed.clear();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Entry& entry = Entries[i];
+            if (IsStable(i, entry, inputs[i]))
+            {
+                entry.Stable = true;
+                if (entry.Reuse)
+                    stableError += inputs[i].ReuseError;
+            }
+            else
+            {
+                entry.Stable = false;
+                Changed.push_back(i);
+            }
+        }
+
+        if (stableError > 0.0f)
+        {
+            ++Stats.Requests;
+            if (!budget.Request(ErrorType::Temporal, stableError))
+            {
+                // El presupuesto bajó: nada es estable este frame
+                Changed.clear();
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    Entries[i].Stable = false;
+                    Changed.push_back(i);
+                }
+            }
+        }
+
+        // 2) Regiones que cambiaron: decisión nueva, una petición cada una
+        for (uint32_t i : Changed)
+        {
+            Entry& entry = Entries[i];
+            const TemporalReuseInput& input = inputs[i];
+
+            entry.Reuse = false;
+            if (input.Disocclusion <= Thresholds.MaxDisocclusion)
+            {
+                ++Stats.Requests;
+                entry.Reuse = budget.Request(ErrorType::Temporal, input.ReuseError);
+            }
+
+            entry.Velocity = input.Velocity;
+            entry.Valid    = true;
+            ++Stats.Reevaluated;
+        }
+
+        for (const Entry& entry : Entries)
+        {
+            Stats.Stable += entry.Stable;
+            Stats.Reused += entry.Reuse;
+        }
+    }
+
+    bool ShouldReuse(uint32_t region) const { return Entries[region].Reuse; }
+
+    const TemporalReuseStats& GetStats() const { return Stats; }
+
+private:
+    struct Entry
+    {
+        float    Velocity = 0.0f;   // velocidad con la que se decidió
+        bool     Reuse    = false;
+        bool     Valid    = false;
+        bool     Stable   = false;
+    };
+
+    // El refresco periódico se escalona por región: ~1/intervalo de las
+    // regiones por frame, sin un pico cuando caducan todas a la vez
+    bool IsStable(uint32_t region, const Entry& entry, const TemporalReuseInput& input) const
+    {
+        return entry.Valid &&
+               (Frame + region) % Thresholds.RefreshInterval != 0 &&
+               input.Disocclusion <= Thresholds.MaxDisocclusion &&
+               std::fabs(input.Velocity - entry.Velocity) <= Thresholds.VelocityDelta;
+    }
+
+    std::vector<Entry>    Entries;
+    std::vector<uint32_t> Changed;
+
+    TemporalReuseThresholds Thresholds;
+    TemporalReuseStats      Stats = {};
+    uint32_t                Frame = 0;
+};
+
+
+// Benchmark de la cache: Requests por frame en una escena estática
+// (velocidades que apenas oscilan, sin desoclusión) frente a una en
+// movimiento (velocidades que saltan y desoclusión aleatoria), y frente
+// a decidir cada región cada frame (una petición por región).
+struct TemporalReuseBenchmarkResult
+{
+    float  StaticRequestsPerFrame;
+    float  MovingRequestsPerFrame;
+    float  NaiveRequestsPerFrame;   // una por región (en la estática todas son elegibles)
+    float  StaticReuseRatio;        // regiones reutilizadas / regiones
+    double StaticUpdateUs;
+    double MovingUpdateUs;
+};
+
+inline TemporalReuseBenchmarkResult RunTemporalReuseBenchmark(uint32_t regions, uint32_t frames)
+{
+    TemporalReuseBenchmarkResult result = {};
+    regions = std::max<uint32_t>(1, regions);
+    frames  = std::max<uint32_t>(2, frames);
+
+    std::vector<TemporalReuseInput> inputs(regions);
+
+    // La suma de todas las regiones cabe en la mitad del límite Temporal
+    const float reuseError = 0.5f * VisualErrorTraits::BaseLimits[(uint32_t)ErrorType::Temporal] / (float)regions;
+
+    auto run = [&](bool moving, float& requestsPerFrame, double& updateUs, float& reuseRatio)
+    {
+        TemporalReuseCache cache;
+        ErrorBudgetSystem  budget;
+        cache.Resize(regions);
+
+        uint32_t random   = 12345;
+        uint64_t requests = 0;
+        uint64_t reused   = 0;
+        double   totalUs  = 0.0;
+
+        for (uint32_t frame = 0; frame < frames; ++frame)
+        {
+            for (uint32_t i = 0; i < regions; ++i)
+            {
+                random = random * 1664525u + 1013904223u;
+                const float noise = (float)(random >> 8) / (float)(1u << 24);   // 0..1
+
+                TemporalReuseInput& input = inputs[i];
+                input.Velocity     = moving ? noise * 8.0f : 0.2f + noise * 0.2f;
+                input.Disocclusion = moving ? noise * 0.1f : 0.0f;
+                input.ReuseError   = reuseError;
+            }
+
+            budget.BeginFrame();
+
+            const auto start = std::chrono::steady_clock::now();
+            cache.Update(inputs.data(), budget);
+            const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+            // El primer frame decide todo y no puntúa
+            if (frame == 0)
+                continue;
+
+            totalUs  += us;
+            requests += cache.GetStats().Requests;
+            reused   += cache.GetStats().Reused;
+        }
+
+        const uint32_t scored = frames - 1;
+        requestsPerFrame = (float)requests / (float)scored;
+        updateUs         = totalUs / scored;
+        reuseRatio       = (float)reused / ((float)scored * (float)regions);
+    };
+
+    float movingReuse = 0.0f;
+    run(false, result.StaticRequestsPerFrame, result.StaticUpdateUs, result.StaticReuseRatio);
+    run(true,  result.MovingRequestsPerFrame, result.MovingUpdateUs, movingReuse);
+    result.NaiveRequestsPerFrame = (float)regions;
+    return result;
+}
+
+
+// Ejemplo de uso
+// ReuseCache.Resize(tilesX * tilesY);
+// ReduceVelocityPerTile(velocityBuffer, tileInputs);
+// ReuseCache.Update(tileInputs.data(), ErrorSystem);
+// if (ReuseCache.ShouldReuse(tile)) Reproject(tile); else Shade(tile);
+}
@@ -0,0 +1,494 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Texture Mip Residency
+
+// Objetivo:
+// Decidir cada frame qué mips cargar y cuáles expulsar para que
+// la residencia de texturas quepa en su pool y las subidas del frame
+// quepan en FrameMemoryDomain::Textures, cobrando como error espacial
+// cada mip que falta respecto a lo deseado.
+
+// Filosofía:
+// - Un mip vale lo que aporta en pantalla dividido por lo que pesa
+// - Solo se expulsa lo que vale menos que lo que entra
+// - Un mip que falta es error espacial y se paga como tal
+// - Coste por cambio: colas por cubo persistentes, solo se recoloca lo que cambia
+
+#pragma once
+
+#include "TXErrorBudget.cpp"
+#include "TXFrameMemoryBudget.cpp"
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace TX
+{
+
+// Textura registrada en el gestor
+struct TextureResidencyDesc
+{
+    uint64_t Mip0Bytes;           // bytes del mip 0
+    uint8_t  MipCount;            // el último mip (cola) siempre está residente
+    float    SpatialErrorPerMip;  // error por cada mip que falta
+};
+
+// Cambio de residencia planificado para este frame
+struct TextureMipChange
+{
+    uint32_t Texture;
+    uint8_t  FromMip;
+    uint8_t  ToMip;
+    uint64_t Bytes;
+};
+
+// Gestor de residencia de mips
+class TextureResidencyManager
+{
+public:
+    // poolBytes: memoria total para mips residentes
+    void Initialize(uint64_t poolBytes)
+    {
+        PoolBytes     = poolBytes;
+        ResidentBytes = 0;
+        MissingError  = 0.0;
+        Textures.clear();
+        Dirty.clear();
+        for (int32_t b = 0; b < BUCKET_COUNT; ++b)
+        {
+            LoadQueues[b].clear();
+            EvictQueues[b].clear();
+        }
+    }
+
+    uint32_t Register(const TextureResidencyDesc& desc)
+    {
+        TextureState state;
+        state.Mip0Bytes          = desc.Mip0Bytes;
+        state.Mip0Log            = LogBits((float)desc.Mip0Bytes);
+        state.MipCount           = std::max<uint8_t>(desc.MipCount, 1);
+        state.SpatialErrorPerMip = desc.SpatialErrorPerMip;
+        state.ResidentMip        = state.MipCount - 1;
+        state.DesiredMip         = state.ResidentMip;
+        state.ScreenNeed         = 0.0f;
+        state.Missing            = 0.0f;
+        state.TouchedFrame       = Frame;
+        state.LoadBucket         = 0;
+        state.EvictBucket        = 0;
+        state.LoadSlot           = NOT_QUEUED;
+        state.EvictSlot          = NOT_QUEUED;
+        state.Dirty              = 0;
+        state.Victim             = 0;
+
+        ResidentBytes += MipBytes(state, state.ResidentMip);
+        Textures.push_back(state);
+
+        const uint32_t texture = (uint32_t)Textures.size() - 1;
+        MarkDirty(texture);
+        return texture;
+    }
+
+    // Necesidad del frame (desde visibilidad / feedback de muestreo).
+    // Solo una necesidad distinta recalcula los cubos de la textura.
+    void SetNeed(uint32_t texture, uint8_t desiredMip, float screenNeed)
+    {
+        TextureState& state = Textures[texture];
+        desiredMip = std::min<uint8_t>(desiredMip, state.MipCount - 1);
+        if (state.DesiredMip == desiredMip && state.ScreenNeed == screenNeed)
+            return;
+
+        state.DesiredMip = desiredMip;
+        state.ScreenNeed = screenNeed;
+        MarkDirty(texture);
+    }
+
+    // Planifica cargas y expulsiones del frame (un mip por textura y frame).
+    // Las cargas consumen Textures en FrameMemoryBudgetSystem; los mips
+    // que siguen faltando se cobran como ErrorType::Spatial.
+    // Devuelve false si ese error no cupo entero (ver ChargeSpatialError).
+    bool Update(FrameMemoryBudgetSystem& memory, ErrorBudgetSystem& error)
+    {
+        Loads.clear();
+        Evictions.clear();
+        ++Frame;
+
+        RequeueDirty();
+
+        // Cargas de mayor a menor valor; expulsiones de menor a mayor.
+        // Las colas no cambian durante el recorrido: lo tocado se
+        // recoloca al principio del frame siguiente. Las víctimas se
+        // reúnen como candidatas y solo se expulsan si la carga cabe;
+        // si no, quedan para la siguiente carga (que vale menos y pesa
+        // igual o menos) sin volver a recorrerlas.
+        int32_t  evictBucket = 0;
+        uint32_t evictSlot   = 0;
+
+        Victims.clear();
+        VictimsHead = 0;
+        VictimBytes = 0;
+
+        for (int32_t b = BUCKET_COUNT; b-- > 0; )
+        {
+            for (const uint32_t index : LoadQueues[b])
+            {
+                TextureState& state = Textures[index];
+                if (state.TouchedFrame == Frame)
+                    continue;
+
+                const uint8_t  mip   = state.ResidentMip - 1;
+                const uint64_t bytes = MipBytes(state, mip);
+
+                if (memory.GetRemaining(FrameMemoryDomain::Textures) < bytes)
+                    continue;
+
+                // Candidatas de cubos >= b ya no valen menos que esta carga
+                while (VictimsHead < Victims.size() && Textures[Victims.back()].EvictBucket >= b)
+                    PopVictim();
+
+                // La propia textura no puede ser su víctima: se descarta
+                // desde ella y el recorrido sigue detrás
+                if (state.Victim)
+                {
+                    while (Victims.back() != index)
+                        PopVictim();
+                    PopVictim();
+                    evictBucket = state.EvictBucket;
+                    evictSlot   = state.EvictSlot;
+                }
+
+                // Hacer sitio en el pool solo con mips que valen menos
+                while (ResidentBytes - VictimBytes + bytes > PoolBytes && evictBucket < b)
+                {
+                    const std::vector<uint32_t>& queue = EvictQueues[evictBucket];
+                    if (evictSlot >= queue.size())
+                    {
+                        ++evictBucket;
+                        evictSlot = 0;
+                        continue;
+                    }
+
+                    const uint32_t victim = queue[evictSlot++];
+                    TextureState& v = Textures[victim];
+                    if (v.TouchedFrame == Frame || victim == index)
+                        continue;
+
+                    v.Victim = 1;
+                    Victims.push_back(victim);
+                    VictimBytes += MipBytes(v, v.ResidentMip);
+                }
+
+                // No cabe ni con todas las candidatas: nada se expulsa
+                if (ResidentBytes - VictimBytes + bytes > PoolBytes)
+                    continue;
+
+                // Se expulsa solo el prefijo (las de menor valor) necesario
+                while (ResidentBytes + bytes > PoolBytes)
+                    EvictVictim(Victims[VictimsHead++]);
+
+                memory.Request(FrameMemoryDomain::Textures, bytes);
+                Loads.push_back({ index, state.ResidentMip, mip, bytes });
+                ResidentBytes    += bytes;
+                state.ResidentMip = mip;
+                Touch(index);
+            }
+        }
+
+        while (VictimsHead < Victims.size())
+            PopVictim();
+
+        return ChargeSpatialError(error);
+    }
+
+    // Resultado del frame
+    const std::vector<TextureMipChange>& GetLoads() const     { return Loads; }
+    const std::vector<TextureMipChange>& GetEvictions() const { return Evictions; }
+
+    // Telemetría
+    uint64_t GetResidentBytes() const       { return ResidentBytes; }
+    float    GetSpatialErrorCharged() const { return SpatialErrorCharged; }
+    bool     IsErrorOverBudget() const      { return ErrorOverBudget; }
+    uint8_t  GetResidentMip(uint32_t texture) const { return Textures[texture].ResidentMip; }
+
+private:
+    static constexpr int32_t  BUCKET_COUNT = 1024;
+    static constexpr int32_t  LOG_BITS_ONE = 508;   // LogBits(1.0f)
+    static constexpr uint32_t NOT_QUEUED   = ~0u;
+
+    struct TextureState
+    {
+        uint64_t Mip0Bytes;
+        int32_t  Mip0Log;        // LogBits(Mip0Bytes)
+        uint32_t TouchedFrame;   // último frame en que cambió
+        float    SpatialErrorPerMip;
+        float    ScreenNeed;
+        float    Missing;        // su parte de MissingError
+        uint32_t LoadSlot;       // posición en LoadQueues[LoadBucket] o NOT_QUEUED
+        uint32_t EvictSlot;      // posición en EvictQueues[EvictBucket] o NOT_QUEUED
+        uint16_t LoadBucket;
+        uint16_t EvictBucket;
+        uint8_t  MipCount;
+        uint8_t  ResidentMip;    // mip más fino residente (0 = resolución completa)
+        uint8_t  DesiredMip;
+        uint8_t  Dirty;          // cubos pendientes de recalcular
+        uint8_t  Victim;         // candidata a expulsión pendiente en Update
+    };
+
+    static uint64_t MipBytes(const TextureState& state, uint8_t mip)
+    {
+        const uint64_t bytes = state.Mip0Bytes >> (2u * mip);
+        return bytes ? bytes : 1;
+    }
+
+    // Escala logarítmica barata: bits altos del float positivo
+    // (exponente y dos bits de mantisa), 4 unidades por octava
+    static int32_t LogBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (int32_t)(bits >> 21);
+    }
+
+    // Cubo monótono con error/bytes sin dividir: en escala logarítmica
+    // la división es una resta y cada mip pesa 4 veces menos (8 unidades)
+    static uint16_t Bucket(const TextureState& state, uint8_t mip)
+    {
+        const float   error  = MipError(state);
+        const int32_t bucket = LogBits(error) - state.Mip0Log + 8 * mip + LOG_BITS_ONE;
+        const int32_t value  = std::min<int32_t>(std::max<int32_t>(bucket, 1), BUCKET_COUNT - 1);
+
+        // Más fino de lo necesario: gratis de expulsar
+        const bool free = mip < state.DesiredMip || !(error > 0.0f);
+        return (uint16_t)(free ? 0 : value);
+    }
+
+    // Error de cada mip que falta
+    static float MipError(const TextureState& state)
+    {
+        return state.ScreenNeed * state.SpatialErrorPerMip;
+    }
+
+    static float MissingOf(const TextureState& state)
+    {
+        const uint32_t missing = state.ResidentMip > state.DesiredMip ? state.ResidentMip - state.DesiredMip : 0;
+        return MipError(state) * (float)missing;
+    }
+
+    void MarkDirty(uint32_t texture)
+    {
+        TextureState& state = Textures[texture];
+        if (state.Dirty)
+            return;
+        state.Dirty = 1;
+        Dirty.push_back(texture);
+    }
+
+    // Cambio de residencia dentro de Update: el error del frame se
+    // corrige ya y los cubos en el frame siguiente
+    void Touch(uint32_t texture)
+    {
+        TextureState& state = Textures[texture];
+        const float missing = MissingOf(state);
+        MissingError      += (double)missing - (double)state.Missing;
+        state.Missing      = missing;
+        state.TouchedFrame = Frame;
+        MarkDirty(texture);
+    }
+
+    // Candidata descartada (la última reunida)
+    void PopVictim()
+    {
+        TextureState& v = Textures[Victims.back()];
+        VictimBytes -= MipBytes(v, v.ResidentMip);
+        v.Victim = 0;
+        Victims.pop_back();
+    }
+
+    // Expulsión confirmada de una candidata: baja un mip
+    void EvictVictim(uint32_t victim)
+    {
+        TextureState& v = Textures[victim];
+        const uint64_t freed = MipBytes(v, v.ResidentMip);
+        Evictions.push_back({ victim, v.ResidentMip, (uint8_t)(v.ResidentMip + 1), freed });
+        VictimBytes   -= freed;
+        ResidentBytes -= freed;
+        v.ResidentMip += 1;
+        v.Victim       = 0;
+        Touch(victim);
+    }
+
+    // Cola por cubo sin orden interno: quitar es cambiar por el último
+    void Enqueue(std::vector<uint32_t>& queue, uint32_t TextureState::* slot, uint32_t texture)
+    {
+        Textures[texture].*slot = (uint32_t)queue.size();
+        queue.push_back(texture);
+    }
+
+    void Dequeue(std::vector<uint32_t>& queue, uint32_t TextureState::* slot, uint32_t texture)
+    {
+        const uint32_t at   = Textures[texture].*slot;
+        const uint32_t last = queue.back();
+        queue[at] = last;
+        Textures[last].*slot = at;
+        queue.pop_back();
+        Textures[texture].*slot = NOT_QUEUED;
+    }
+
+    // Recoloca en sus cubos de carga y expulsión solo las texturas que
+    // cambiaron de necesidad o de residencia desde el último Update:
+    // el coste por frame sigue a los cambios, no a las 50k texturas
+    void RequeueDirty()
+    {
+        for (const uint32_t texture : Dirty)
+        {
+            TextureState& state = Textures[texture];
+            state.Dirty = 0;
+
+            if (state.LoadSlot != NOT_QUEUED)
+                Dequeue(LoadQueues[state.LoadBucket], &TextureState::LoadSlot, texture);
+            if (state.EvictSlot != NOT_QUEUED)
+                Dequeue(EvictQueues[state.EvictBucket], &TextureState::EvictSlot, texture);
+
+            const bool wantsLoad = state.ResidentMip > state.DesiredMip;
+            const bool canEvict  = state.ResidentMip + 1 < state.MipCount;
+
+            state.LoadBucket  = wantsLoad ? Bucket(state, state.ResidentMip - 1) : 0;
+            state.EvictBucket = Bucket(state, state.ResidentMip);
+
+            if (wantsLoad)
+                Enqueue(LoadQueues[state.LoadBucket], &TextureState::LoadSlot, texture);
+            if (canEvict)
+                Enqueue(EvictQueues[state.EvictBucket], &TextureState::EvictSlot, texture);
+
+            const float missing = MissingOf(state);
+            MissingError += (double)missing - (double)state.Missing;
+            state.Missing = missing;
+        }
+
+        Dirty.clear();
+    }
+
+    // Todo mip que falta respecto al deseado es error espacial
+    // (suma por textura mantenida en RequeueDirty y en cada carga/expulsión).
+    // Devuelve el resultado del Request: si no cabe se cobra lo que queda
+    // y el resto lo verá AdaptiveQuality por saturación.
+    bool ChargeSpatialError(ErrorBudgetSystem& error)
+    {
+        float total = std::max(0.0f, (float)MissingError);
+
+        ErrorOverBudget = !error.Request(ErrorType::Spatial, total);
+        if (ErrorOverBudget)
+        {
+            total = error.GetRemaining(ErrorType::Spatial);
+            error.Request(ErrorType::Spatial, total);
+        }
+
+        SpatialErrorCharged = total;
+        return !ErrorOverBudget;
+    }
+
+    std::vector<TextureState>     Textures;
+    std::vector<uint32_t>         Dirty;
+    std::vector<TextureMipChange> Loads;
+    std::vector<TextureMipChange> Evictions;
+    std::vector<uint32_t>         Victims;          // candidatas de Update en orden de recorrido
+    size_t                        VictimsHead = 0;  // las anteriores ya se expulsaron
+    uint64_t                      VictimBytes = 0;  // bytes de las pendientes
+
+    std::vector<uint32_t> LoadQueues[BUCKET_COUNT];    // candidatos a carga por cubo
+    std::vector<uint32_t> EvictQueues[BUCKET_COUNT];   // candidatos a expulsión por cubo
+
+    uint32_t Frame               = 0;
+    uint64_t PoolBytes           = 0;
+    uint64_t ResidentBytes       = 0;
+    double   MissingError        = 0.0;   // suma de TextureState::Missing
+    float    SpatialErrorCharged = 0.0f;
+    bool     ErrorOverBudget     = false;
+};
+
+
+// Benchmark del gestor: coste de Update por frame con una fracción de
+// texturas que cambian de necesidad cada frame (changeRatio = 1: todas,
+// caso de vaciado aleatorio) y comprobación de que el pool nunca se pasa.
+// Objetivo: 50k texturas por debajo de 0,5 ms. Se cumple cuando cambia
+// una fracción acotada por frame; con todas cambiando cada frame no: el
+// coste sigue a los cambios y recolocar 50k texturas ya pasa de 1 ms.
+struct TextureResidencyBenchmarkResult
+{
+    double   UpdateMs;            // media por Update
+    double   PeakUpdateMs;        // peor Update medido
+    float    LoadsPerFrame;
+    float    EvictionsPerFrame;
+    uint32_t PoolOverflowFrames;  // frames con ResidentBytes > poolBytes
+};
+
+inline TextureResidencyBenchmarkResult RunTextureResidencyBenchmark(const TextureResidencyDesc* textures, uint32_t count,
+                                                                    uint64_t poolBytes, uint64_t uploadBytesPerFrame,
+                                                                    uint32_t frames, float changeRatio)
+{
+    TextureResidencyBenchmarkResult result = {};
+
+    TextureResidencyManager residency;
+    FrameMemoryBudgetSystem memory;
+    ErrorBudgetSystem       error;
+
+    residency.Initialize(poolBytes);
+    memory.Initialize(uploadBytesPerFrame * 4);   // Textures = 25 %
+    for (uint32_t i = 0; i < count; ++i)
+        residency.Register(textures[i]);
+
+    frames = std::max<uint32_t>(2, frames);
+    const uint32_t threshold = (uint32_t)((double)std::min(std::max(changeRatio, 0.0f), 1.0f) * 4294967295.0);
+
+    uint32_t random    = 12345;
+    uint64_t loads     = 0;
+    uint64_t evictions = 0;
+    double   totalMs   = 0.0;
+
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            random = random * 1664525u + 1013904223u;
+            if (frame > 0 && random > threshold)
+                continue;
+
+            random = random * 1664525u + 1013904223u;
+            const uint8_t mip  = (uint8_t)((random >> 8) % std::max<uint8_t>(textures[i].MipCount, 1));
+            const float   need = (float)((random >> 16) & 0xFFu) / 255.0f + 1.0f / 256.0f;
+            residency.SetNeed(i, mip, need);
+        }
+
+        memory.BeginFrame();
+        error.BeginFrame();
+
+        const auto start = std::chrono::steady_clock::now();
+        residency.Update(memory, error);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // El primer frame encola las 50k texturas y no puntúa
+        if (frame == 0)
+            continue;
+
+        totalMs            += ms;
+        result.PeakUpdateMs = std::max(result.PeakUpdateMs, ms);
+        loads              += residency.GetLoads().size();
+        evictions          += residency.GetEvictions().size();
+        if (residency.GetResidentBytes() > poolBytes)
+            ++result.PoolOverflowFrames;
+    }
+
+    const uint32_t scored = frames - 1;
+    result.UpdateMs          = totalMs / scored;
+    result.LoadsPerFrame     = (float)loads / (float)scored;
+    result.EvictionsPerFrame = (float)evictions / (float)scored;
+    return result;
+}
+
+
+// Ejemplo de uso
+// Residency.SetNeed(tex, desiredMip, screenCoverage);
+// Residency.Update(MemorySystem, ErrorSystem);
+// for (const TextureMipChange& load : Residency.GetLoads()) Reads.Submit(...);
+}
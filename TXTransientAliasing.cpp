@@ -0,0 +1,334 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Transient Resource Aliasing
+
+// Objetivo:
+// Cobrar a FrameMemoryBudgetSystem solo el pico real de memoria
+// transitoria del frame, no la suma de todos los recursos.
+
+// Filosofía:
+// - Un recurso solo existe entre su primer y su último pase
+// - Dos recursos que no conviven pueden compartir bytes
+// - El plan se calcula una vez y se reutiliza mientras el frame no cambie
+// - El presupuesto paga el pico, no la suma
+
+#pragma once
+
+#include "TXFrameMemoryBudget.cpp"
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace TX
+{
+
+// Recurso transitorio declarado por el render graph
+struct TransientResourceDesc
+{
+    uint64_t Bytes;
+    uint32_t Alignment;   // potencia de dos
+    uint16_t FirstPass;   // primer pase que lo usa
+    uint16_t LastPass;    // último pase que lo usa (inclusive)
+};
+
+// Planificador de aliasing (barrido en el tiempo, first-fit por offset)
+class TransientAliasingPlanner
+{
+public:
+    // Planifica los offsets y cobra el pico al dominio.
+    // Con respaldo real reserva el bloque y GetAddress devuelve punteros.
+    // Falla sin tocar el plan si algún recurso muere antes de nacer o su
+    // alineación no es potencia de dos.
+    bool Plan(const TransientResourceDesc* resources, uint32_t count,
+              FrameMemoryDomain domain, FrameMemoryBudgetSystem& memory)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const TransientResourceDesc& r = resources[i];
+            if (r.FirstPass > r.LastPass || (r.Alignment & (r.Alignment - 1)) != 0)
+                return false;
+        }
+
+        Cached = IsSameFrame(resources, count);
+        if (!Cached)
+            Build(resources, count);
+
+        Base = nullptr;
+        if (PeakBytes == 0)
+            return true;
+
+        if (memory.HasBacking())
+        {
+            Base = static_cast<uint8_t*>(memory.Allocate(domain, PeakBytes, MaxAlignment));
+            return Base != nullptr;
+        }
+
+        return memory.Request(domain, PeakBytes);
+    }
+
+    uint64_t GetOffset(uint32_t index) const { return Offsets[index]; }
+    void*    GetAddress(uint32_t index) const { return Base ? Base + Offsets[index] : nullptr; }
+
+    // Telemetría
+    uint64_t GetPeakBytes() const   { return PeakBytes; }
+    uint64_t GetNaiveBytes() const  { return NaiveBytes; }
+    bool     WasCached() const      { return Cached; }
+
+    void Invalidate()
+    {
+        Resources.clear();
+        Offsets.clear();
+        PeakBytes  = 0;
+        NaiveBytes = 0;
+    }
+
+private:
+    static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Frames idénticos reutilizan el plan sin recalcular
+    bool IsSameFrame(const TransientResourceDesc* resources, uint32_t count) const
+    {
+        return count == Resources.size() && count > 0 &&
+               std::memcmp(resources, Resources.data(), count * sizeof(TransientResourceDesc)) == 0;
+    }
+
+    // Barrido en el tiempo: pase a pase se devuelven los recursos que ya
+    // murieron y se colocan los que nacen, cada uno en el primer hueco
+    // libre. Un único vector de huecos ordenado por offset, sin mirar los
+    // pases futuros: coste O(n log n + n · huecos), independiente de la
+    // duración. Los huecos se fusionan al liberar y suelen ser pocos.
+    // Requiere FirstPass <= LastPass (lo comprueba Plan).
+    void Build(const TransientResourceDesc* resources, uint32_t count)
+    {
+        Resources.assign(resources, resources + count);
+        Offsets.assign(count, 0);
+        Order.resize(count);
+        NextExpiring.resize(count);
+
+        PeakBytes    = 0;
+        NaiveBytes   = 0;
+        MaxAlignment = 16;
+
+        uint32_t passCount = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const TransientResourceDesc& r = resources[i];
+            NaiveBytes   += r.Bytes;
+            MaxAlignment  = std::max<uint64_t>(MaxAlignment, r.Alignment);
+            passCount     = std::max<uint32_t>(passCount, r.LastPass + 1u);
+        }
+
+        // Orden por primer pase (counting sort) y dentro del pase los que
+        // viven más y los mayores primero; empates por índice (determinista)
+        PassStart.assign(passCount + 1, 0);
+        for (uint32_t i = 0; i < count; ++i)
+            ++PassStart[resources[i].FirstPass + 1];
+        for (uint32_t p = 0; p < passCount; ++p)
+            PassStart[p + 1] += PassStart[p];
+
+        Expiring.assign(PassStart.begin(), PassStart.end() - 1);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const TransientResourceDesc& r = resources[i];
+            Order[Expiring[r.FirstPass]++] = { r.Bytes, r.LastPass, i };
+        }
+
+        for (uint32_t p = 0; p < passCount; ++p)
+        {
+            std::sort(Order.begin() + PassStart[p], Order.begin() + PassStart[p + 1],
+                [](const SortKey& a, const SortKey& b)
+            {
+                if (a.LastPass != b.LastPass)
+                    return a.LastPass > b.LastPass;
+                if (a.Bytes != b.Bytes)
+                    return a.Bytes > b.Bytes;
+                return a.Index < b.Index;
+            });
+        }
+
+        // Listas de recursos que mueren en cada pase
+        Expiring.assign(passCount, INVALID_INDEX);
+        Free.clear();
+        Top = 0;
+
+        uint32_t pass = 0;
+        for (const SortKey& key : Order)
+        {
+            const uint32_t index = key.Index;
+            const TransientResourceDesc& r = resources[index];
+
+            for (; pass < r.FirstPass; ++pass)
+            {
+                for (uint32_t dead = Expiring[pass]; dead != INVALID_INDEX; dead = NextExpiring[dead])
+                    Release(Offsets[dead], Offsets[dead] + resources[dead].Bytes);
+            }
+
+            // Sin bytes no ocupa nada: offset 0 y fuera del plan
+            if (r.Bytes == 0)
+                continue;
+
+            const uint64_t offset = Place(r.Bytes, r.Alignment ? r.Alignment : 1);
+            Offsets[index] = offset;
+            PeakBytes = std::max(PeakBytes, offset + r.Bytes);
+
+            NextExpiring[index] = Expiring[r.LastPass];
+            Expiring[r.LastPass] = index;
+        }
+    }
+
+    // Primer hueco donde cabe alineado; si ninguno, sobre la cima
+    uint64_t Place(uint64_t bytes, uint64_t alignment)
+    {
+        for (size_t g = 0; g < Free.size(); ++g)
+        {
+            const Gap gap = Free[g];
+            const uint64_t begin = AlignUp(gap.Begin, alignment);
+            const uint64_t end   = begin + bytes;
+            if (end > gap.End)
+                continue;
+
+            // Dividir el hueco ocupado en sus restos
+            if (begin > gap.Begin && end < gap.End)
+            {
+                Free[g].End = begin;
+                Free.insert(Free.begin() + g + 1, { end, gap.End });
+            }
+            else if (begin > gap.Begin)
+                Free[g].End = begin;
+            else if (end < gap.End)
+                Free[g].Begin = end;
+            else
+                Free.erase(Free.begin() + g);
+            return begin;
+        }
+
+        const uint64_t begin = AlignUp(Top, alignment);
+        if (begin > Top)
+            Free.push_back({ Top, begin });
+        Top = begin + bytes;
+        return begin;
+    }
+
+    // Devuelve un rango fusionándolo con sus vecinos y con la cima
+    void Release(uint64_t begin, uint64_t end)
+    {
+        auto it = std::lower_bound(Free.begin(), Free.end(), begin,
+            [](const Gap& gap, uint64_t value) { return gap.Begin < value; });
+
+        const bool mergeNext = it != Free.end() && it->Begin == end;
+        const bool mergePrev = it != Free.begin() && (it - 1)->End == begin;
+
+        if (mergePrev && mergeNext)
+        {
+            (it - 1)->End = it->End;
+            Free.erase(it);
+        }
+        else if (mergePrev)
+            (it - 1)->End = end;
+        else if (mergeNext)
+            it->Begin = begin;
+        else
+            Free.insert(it, { begin, end });
+
+        if (!Free.empty() && Free.back().End == Top)
+        {
+            Top = Free.back().Begin;
+            Free.pop_back();
+        }
+    }
+
+    static constexpr uint32_t INVALID_INDEX = ~0u;
+
+    struct SortKey
+    {
+        uint64_t Bytes;
+        uint32_t LastPass;
+        uint32_t Index;
+    };
+
+    struct Gap
+    {
+        uint64_t Begin;
+        uint64_t End;
+    };
+
+    std::vector<TransientResourceDesc> Resources;   // descripción del último plan
+    std::vector<uint64_t>              Offsets;
+    std::vector<SortKey>               Order;
+    std::vector<uint32_t>              PassStart;      // inicio de cada pase en Order
+    std::vector<uint32_t>              Expiring;       // cabeza de la lista de cada pase
+    std::vector<uint32_t>              NextExpiring;
+    std::vector<Gap>                   Free;           // huecos bajo la cima, ordenados por offset
+    uint64_t                           Top = 0;
+
+    uint8_t* Base         = nullptr;
+    uint64_t PeakBytes    = 0;
+    uint64_t NaiveBytes   = 0;
+    uint64_t MaxAlignment = 16;
+    bool     Cached       = false;
+};
+
+
+// Benchmark del planificador: tiempo de Build frente al pico obtenido y
+// a la cota inferior (mayor suma de bytes vivos en un mismo pase).
+struct TransientAliasingBenchmarkResult
+{
+    double   BuildMs;           // media por plan, sin caché
+    uint64_t PeakBytes;
+    uint64_t LowerBoundBytes;
+    uint64_t NaiveBytes;
+};
+
+inline TransientAliasingBenchmarkResult RunTransientAliasingBenchmark(const TransientResourceDesc* resources,
+                                                                      uint32_t count, uint32_t iterations)
+{
+    TransientAliasingBenchmarkResult result = {};
+
+    uint32_t passCount = 0;
+    for (uint32_t i = 0; i < count; ++i)
+        passCount = std::max<uint32_t>(passCount, resources[i].LastPass + 1u);
+
+    std::vector<uint64_t> live(passCount + 1, 0);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        live[resources[i].FirstPass]    += resources[i].Bytes;
+        live[resources[i].LastPass + 1] -= resources[i].Bytes;
+    }
+    uint64_t bytes = 0;
+    for (uint32_t p = 0; p < passCount; ++p)
+    {
+        bytes += live[p];
+        result.LowerBoundBytes = std::max(result.LowerBoundBytes, bytes);
+    }
+
+    // Sin respaldo y con el plan invalidado en cada vuelta: se mide Build
+    FrameMemoryBudgetSystem memory;
+    memory.Initialize(1ull << 48);
+
+    TransientAliasingPlanner planner;
+    iterations = std::max<uint32_t>(1, iterations);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        planner.Invalidate();
+        memory.BeginFrame();
+        planner.Plan(resources, count, FrameMemoryDomain::Textures, memory);
+    }
+    result.BuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    result.PeakBytes  = planner.GetPeakBytes();
+    result.NaiveBytes = planner.GetNaiveBytes();
+    return result;
+}
+
+
+// Ejemplo de uso
+// Planner.Plan(descs, count, FrameMemoryDomain::Textures, MemorySystem);
+// void* bloom = Planner.GetAddress(bloomIndex);
+}
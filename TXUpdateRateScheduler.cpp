@@ -0,0 +1,374 @@
+// TX Engine — Technologic Experience Engine
+// Técnica: Update-Rate Scheduler
+
+// Objetivo:
+// Decidir cada cuántos frames se actualiza cada animación y cada agente
+// de IA, cobrando la pérdida de frecuencia como error de simulación, y
+// repartir las actualizaciones entre frames para aplanar los picos de CPU.
+
+// Filosofía:
+// - Lo pequeño y lejano puede actualizarse menos sin que se note
+// - Saltar un frame es error; el presupuesto decide cuánto
+// - Intervalos en potencias de dos: las fases encajan en un ciclo fijo
+// - Cada agente entra en la fase menos cargada del ciclo
+
+#pragma once
+
+#include "TXSimulationErrorBudget.cpp"
+
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace TX
+{
+
+constexpr uint8_t UPDATE_RATE_MAX_INTERVAL = 8;   // también la longitud del ciclo
+
+enum class UpdateRateCategory : uint8_t
+{
+    Animation,
+    AI
+};
+
+struct UpdateAgentDesc
+{
+    UpdateRateCategory Category;
+    float   ScreenSize;    // fracción de pantalla (0 = fuera)
+    float   Distance;      // a la cámara (m)
+    float   CostUs;        // coste de una actualización
+    uint8_t MaxInterval;   // 1, 2, 4 u 8 (IA de combate: 1)
+};
+
+// Planificador round-robin con prioridad perceptual
+class UpdateRateScheduler
+{
+public:
+    uint32_t Register(const UpdateAgentDesc& desc)
+    {
+        Agent agent;
+        agent.Desc     = desc;
+        agent.Interval = 0;
+        agent.Phase    = 0;
+        agent.LastUpdateFrame = Frame;
+        agent.Alive    = true;
+
+        if (!FreeAgents.empty())
+        {
+            const uint32_t index = FreeAgents.back();
+            FreeAgents.pop_back();
+            Agents[index] = agent;
+            return index;
+        }
+
+        Agents.push_back(agent);
+        return (uint32_t)Agents.size() - 1;
+    }
+
+    void Unregister(uint32_t index)
+    {
+        Agent& agent = Agents[index];
+        Unassign(agent);
+        agent.Alive = false;
+        FreeAgents.push_back(index);
+    }
+
+    void SetView(uint32_t index, float screenSize, float distance)
+    {
+        Agents[index].Desc.ScreenSize = screenSize;
+        Agents[index].Desc.Distance   = distance;
+    }
+
+    // Ventaja de quien ya tiene un intervalo: compite por él con su peso
+    // reducido en esta fracción, así pequeñas variaciones de tamaño o
+    // distancia no lo hacen oscilar entre dos intervalos cada frame
+    void SetHysteresis(float hysteresis)
+    {
+        Hysteresis = std::min(std::max(hysteresis, 0.0f), 0.9f);
+    }
+
+    // Una vez por frame, antes de actualizar animación e IA
+    void Schedule(SimulationErrorBudgetSystem& budget)
+    {
+        ++Frame;
+
+        Order.clear();
+        for (uint32_t i = 0; i < (uint32_t)Agents.size(); ++i)
+        {
+            Agent& agent = Agents[i];
+            if (!agent.Alive)
+                continue;
+
+            agent.Weight = Perceptibility(agent.Desc);
+            agent.Target = 1;
+            Order.push_back(i);
+        }
+
+        std::stable_sort(Order.begin(), Order.end(), [this](uint32_t a, uint32_t b)
+        {
+            return Agents[a].Weight < Agents[b].Weight;
+        });
+
+        // Se duplica el intervalo de todos un paso cada vez, del menos
+        // perceptible al más, cobrando solo el error añadido (con el peso
+        // real). Quien ya tenía ese intervalo compite con el peso rebajado
+        // por la histéresis: se mezclan las dos subsecuencias de Order,
+        // ya ordenadas, sin reordenar.
+        const float keep = 1.0f - Hysteresis;
+        for (uint8_t interval = 2; interval <= UPDATE_RATE_MAX_INTERVAL; interval *= 2)
+        {
+            const uint32_t count = (uint32_t)Order.size();
+            uint32_t held = 0, other = 0;
+            for (;;)
+            {
+                while (held < count && Agents[Order[held]].Interval < interval)
+                    ++held;
+                while (other < count && Agents[Order[other]].Interval >= interval)
+                    ++other;
+                if (held == count && other == count)
+                    break;
+
+                const bool takeHeld = other == count ||
+                    (held < count && Agents[Order[held]].Weight * keep <= Agents[Order[other]].Weight);
+                Agent& agent = Agents[Order[takeHeld ? held++ : other++]];
+
+                if (agent.Target != interval / 2 || agent.Desc.MaxInterval < interval)
+                    continue;
+
+                const float error = agent.Weight * (float)(interval - agent.Target);
+                if (budget.Request(ErrorTypeOf(agent.Desc.Category), error))
+                    agent.Target = interval;
+            }
+        }
+
+        UpdatedCount = 0;
+        for (uint32_t index : Order)
+        {
+            Agent& agent = Agents[index];
+            if (agent.Target != agent.Interval)
+            {
+                Unassign(agent);
+                Assign(agent, agent.Target);
+                ++IntervalChanges;
+            }
+
+            agent.Update = (Frame + agent.Phase) % agent.Interval == 0;
+            if (agent.Update)
+            {
+                agent.LastUpdateFrame = Frame;
+                ++UpdatedCount;
+            }
+        }
+    }
+
+    bool    ShouldUpdate(uint32_t index) const { return Agents[index].Update; }
+    uint8_t GetInterval(uint32_t index) const  { return Agents[index].Interval; }
+
+    // Para interpolar poses entre actualizaciones: 0 = recién actualizado,
+    // nunca pasa de 1
+    float GetInterpolationAlpha(uint32_t index) const
+    {
+        const Agent& agent = Agents[index];
+        if (agent.Interval == 0)
+            return 0.0f;
+        return std::min(1.0f, (float)(Frame - agent.LastUpdateFrame) / (float)agent.Interval);
+    }
+
+    // Telemetría: coste previsto por frame del ciclo
+    float    GetFrameCostUs() const  { return CycleCost[Frame % UPDATE_RATE_MAX_INTERVAL]; }
+    uint32_t GetUpdatedCount() const { return UpdatedCount; }
+    uint32_t GetIntervalChanges() const { return IntervalChanges; }   // acumulado desde el inicio
+
+    float GetPeakCycleCostUs() const
+    {
+        return *std::max_element(CycleCost, CycleCost + UPDATE_RATE_MAX_INTERVAL);
+    }
+
+    float GetMeanCycleCostUs() const
+    {
+        float total = 0.0f;
+        for (float cost : CycleCost)
+            total += cost;
+        return total / UPDATE_RATE_MAX_INTERVAL;
+    }
+
+private:
+    struct Agent
+    {
+        UpdateAgentDesc Desc;
+        uint32_t LastUpdateFrame;
+        float    Weight;
+        uint8_t  Interval;   // 0 = sin asignar
+        uint8_t  Target;
+        uint8_t  Phase;
+        bool     Update;
+        bool     Alive;
+    };
+
+    static SimulationErrorType ErrorTypeOf(UpdateRateCategory category)
+    {
+        return (category == UpdateRateCategory::Animation) ? SimulationErrorType::AnimationUpdate
+                                                           : SimulationErrorType::AIUpdate;
+    }
+
+    // Tamaño en pantalla (con suelo para lo que está fuera) atenuado con la distancia
+    static float Perceptibility(const UpdateAgentDesc& desc)
+    {
+        const float size = std::max(desc.ScreenSize, 0.001f);
+        return size / (1.0f + desc.Distance * 0.02f);
+    }
+
+    // Fase con menos carga entre los frames del ciclo en que actualizaría.
+    // Solo valen fases cuya próxima actualización no deja pasar más de
+    // 'interval' frames desde la última; si ya pasaron, se actualiza ahora.
+    void Assign(Agent& agent, uint8_t interval)
+    {
+        const uint32_t deadline = std::max(Frame, agent.LastUpdateFrame + interval);
+
+        uint8_t bestPhase = 0;
+        float   bestLoad  = 0.0f;
+        bool    found     = false;
+
+        for (uint8_t phase = 0; phase < interval; ++phase)
+        {
+            const uint32_t next = Frame + (interval - (Frame + phase) % interval) % interval;
+            if (next > deadline)
+                continue;
+
+            float load = 0.0f;
+            for (uint32_t f = 0; f < UPDATE_RATE_MAX_INTERVAL; ++f)
+                if ((f + phase) % interval == 0)
+                    load = std::max(load, CycleCost[f]);
+
+            if (!found || load < bestLoad)
+            {
+                bestPhase = phase;
+                bestLoad  = load;
+                found     = true;
+            }
+        }
+
+        agent.Interval = interval;
+        agent.Phase    = bestPhase;
+        ApplyLoad(agent, agent.Desc.CostUs);
+    }
+
+    void Unassign(Agent& agent)
+    {
+        if (agent.Interval == 0)
+            return;
+
+        ApplyLoad(agent, -agent.Desc.CostUs);
+        agent.Interval = 0;
+    }
+
+    void ApplyLoad(const Agent& agent, float cost)
+    {
+        for (uint32_t f = 0; f < UPDATE_RATE_MAX_INTERVAL; ++f)
+            if ((f + agent.Phase) % agent.Interval == 0)
+                CycleCost[f] += cost;
+    }
+
+    std::vector<Agent>    Agents;
+    std::vector<uint32_t> FreeAgents;
+    std::vector<uint32_t> Order;
+
+    float    CycleCost[UPDATE_RATE_MAX_INTERVAL] = {};
+    float    Hysteresis      = 0.2f;
+    uint32_t Frame           = 0;
+    uint32_t UpdatedCount    = 0;
+    uint32_t IntervalChanges = 0;
+};
+
+
+// Benchmark del planificador: coste de Schedule, pico frente a media del
+// coste de actualización medido frame a frame (y frente a todos en fase
+// 0), cambios de intervalo por frame con vistas que oscilan un poco, y
+// huecos entre actualizaciones por encima del MaxInterval de cada agente.
+struct UpdateRateBenchmarkResult
+{
+    double   ScheduleUs;             // media por Schedule
+    float    PeakFrameCostUs;        // máximo coste medido en un frame
+    float    MeanFrameCostUs;
+    float    NaivePeakFrameCostUs;   // mismos intervalos, todos en fase 0
+    float    IntervalChangesPerFrame;
+    uint32_t MaxGapViolations;       // huecos > MaxInterval
+};
+
+inline UpdateRateBenchmarkResult RunUpdateRateBenchmark(const UpdateAgentDesc* agents, uint32_t count,
+                                                        uint32_t frames, float viewJitter)
+{
+    UpdateRateBenchmarkResult result = {};
+
+    UpdateRateScheduler         scheduler;
+    SimulationErrorBudgetSystem budget;
+    std::vector<uint32_t>       lastUpdate(count, 0);
+
+    for (uint32_t i = 0; i < count; ++i)
+        scheduler.Register(agents[i]);
+
+    // Los primeros ciclos asientan fases e intervalos y no puntúan
+    const uint32_t warmup = 2 * UPDATE_RATE_MAX_INTERVAL;
+    frames = std::max(frames, warmup + 1);
+
+    uint32_t random      = 12345;
+    uint32_t changes     = 0;
+    double   scheduleUs  = 0.0;
+    double   costSum     = 0.0;
+
+    for (uint32_t frame = 1; frame <= frames; ++frame)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            random = random * 1664525u + 1013904223u;
+            const float noise = ((float)(random >> 8) / (float)(1u << 24)) * 2.0f - 1.0f;
+            scheduler.SetView(i, agents[i].ScreenSize * (1.0f + viewJitter * noise), agents[i].Distance);
+        }
+
+        const uint32_t changesBefore = scheduler.GetIntervalChanges();
+        budget.BeginFrame();
+
+        const auto start = std::chrono::steady_clock::now();
+        scheduler.Schedule(budget);
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        float cost = 0.0f;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!scheduler.ShouldUpdate(i))
+                continue;
+
+            cost += agents[i].CostUs;
+            if (frame > warmup && frame - lastUpdate[i] > agents[i].MaxInterval)
+                ++result.MaxGapViolations;
+            lastUpdate[i] = frame;
+        }
+
+        if (frame <= warmup)
+            continue;
+
+        scheduleUs += us;
+        costSum    += cost;
+        changes    += scheduler.GetIntervalChanges() - changesBefore;
+        result.PeakFrameCostUs = std::max(result.PeakFrameCostUs, cost);
+    }
+
+    const uint32_t scored = frames - warmup;
+    result.ScheduleUs              = scheduleUs / scored;
+    result.MeanFrameCostUs         = (float)(costSum / scored);
+    result.IntervalChangesPerFrame = (float)changes / (float)scored;
+
+    // En fase 0 todos coinciden en el primer frame del ciclo
+    for (uint32_t i = 0; i < count; ++i)
+        result.NaivePeakFrameCostUs += agents[i].CostUs;
+
+    return result;
+}
+
+// Ejemplo de uso
+// SimulationBudget.BeginFrame();
+// Scheduler.Schedule(SimulationBudget);
+// if (Scheduler.ShouldUpdate(npc)) Animator.Update(npc);
+// else Animator.Interpolate(npc, Scheduler.GetInterpolationAlpha(npc));
+}